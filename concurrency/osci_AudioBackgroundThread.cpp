@@ -48,7 +48,7 @@ void AudioBackgroundThread::setShouldBeRunning(bool shouldBeRunning, std::functi
 void AudioBackgroundThread::write(juce::AudioBuffer<float>& buffer) {
     if (isPrepared && isThreadRunning()) {
         for (int i = 0; i < buffer.getNumSamples(); i++) {
-            consumer->write(Point::fromAudioBuffer(buffer, i));
+            consumer->write(Point::sampleFromAudioBuffer(buffer, i));
         }
     }
 }
@@ -3,10 +3,10 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include "../frame/osci_Frame.h"
 
 namespace osci {
 
-typedef std::vector<std::unique_ptr<osci::Shape>> Frame;
 class BlockingQueue {
     std::vector<Frame> content;
     std::atomic<int> size = 0;
@@ -33,23 +33,31 @@ public:
         not_full.notify_all();
     }
 
+    // Frames left in a slot are destroyed after the lock is released, so consumers
+    // aren't held up by the shape destructors.
     void push(Frame &&item) {
+        Frame discarded;
         {
             std::unique_lock<std::mutex> lk(mutex);
             not_full.wait(lk, [this]() { return size < content.size() || killed; });
-            content[(head + size) % content.size()] = std::move(item);
+            Frame& slot = content[(head + size) % content.size()];
+            discarded.swap(slot);
+            slot = std::move(item);
             size++;
         }
         not_empty.notify_one();
     }
 
     bool try_push(Frame &&item) {
+        Frame discarded;
         {
             std::unique_lock<std::mutex> lk(mutex);
             if (size == content.size()) {
                 return false;
             }
-            content[(head + size) % content.size()] = std::move(item);
+            Frame& slot = content[(head + size) % content.size()];
+            discarded.swap(slot);
+            slot = std::move(item);
             size++;
         }
         not_empty.notify_one();
@@ -83,10 +91,11 @@ public:
 
     // Atomically discard all queued frames.
     void flush() {
+        std::vector<Frame> discarded(content.size());
         {
             std::unique_lock<std::mutex> lk(mutex);
             for (int i = 0; i < size.load(); i++) {
-                content[(head + i) % content.size()].clear();
+                discarded[i].swap(content[(head + i) % content.size()]);
             }
             size = 0;
             head = 0;
@@ -53,7 +53,7 @@ public:
         returnBuffer.setSize(6, static_cast<int>(size));
         buffer1.setSize(6, static_cast<int>(size));
         buffer2.setSize(6, static_cast<int>(size));
-        queue = std::make_unique<moodycamel::BlockingReaderWriterCircularBuffer<osci::Point>>(2 * size);
+        queue = std::make_unique<moodycamel::BlockingReaderWriterCircularBuffer<osci::PointSample>>(2 * size);
     }
 
     ~BufferConsumer() {}
@@ -69,7 +69,7 @@ public:
         if (blockOnWrite) {
             for (int i = 0; i < returnBuffer.getNumSamples() && blockOnWrite; i++) {
                 auto writePointers = returnBuffer.getArrayOfWritePointers();
-                osci::Point p;
+                osci::PointSample p;
                 queue->wait_dequeue(p);
                 writePointers[0][i] = p.x;
                 writePointers[1][i] = p.y;
@@ -87,10 +87,14 @@ public:
     // make sure that everything waiting on it stops waiting.
     void forceNotify() {
         sema.release();
-        queue->try_enqueue(osci::Point());
+        queue->try_enqueue(osci::PointSample());
     }
 
-    void write(osci::Point point) {
+    void write(const osci::Point& point) {
+        write(point.toSample());
+    }
+
+    void write(osci::PointSample point) {
         if (blockOnWrite) {
             queue->wait_enqueue(point);
         } else {
@@ -135,11 +139,11 @@ public:
             // drain, the first `waitUntilFull()` of the new blocking session
             // would fill `returnBuffer` from those stale points, producing a
             // one-frame "flash back" to the end of the previous recording.
-            osci::Point discarded;
+            osci::PointSample discarded;
             while (queue->try_dequeue(discarded)) {}
             sema.release();
         } else {
-            osci::Point item;
+            osci::PointSample item;
             // We dequeue an item so that the audio thread is unblocked
             // if it's trying to wait until the queue is no longer full.
             queue->try_dequeue(item);
@@ -150,7 +154,7 @@ public:
     }
 
 private:
-    std::unique_ptr<moodycamel::BlockingReaderWriterCircularBuffer<osci::Point>> queue;
+    std::unique_ptr<moodycamel::BlockingReaderWriterCircularBuffer<osci::PointSample>> queue;
     juce::AudioBuffer<float> returnBuffer;
     juce::AudioBuffer<float> buffer1;
     juce::AudioBuffer<float> buffer2;
@@ -0,0 +1,92 @@
+#include "osci_FrameProducerPool.h"
+
+namespace osci {
+
+FrameProducerPool::FrameProducerPool(BlockingQueue& queue, int numThreads, int maxInFlight)
+    : queue(queue), maxInFlight(std::max(1, maxInFlight)), finished(this->maxInFlight), isFinished(this->maxInFlight, false), pool(std::max(1, numThreads)) {}
+
+FrameProducerPool::~FrameProducerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    spaceAvailable.notify_all();
+    allDelivered.notify_all();
+    pool.removeAllJobs(true, 5000);
+}
+
+uint64_t FrameProducerPool::submit(Job job) {
+    uint64_t sequence;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceAvailable.wait(lock, [this]() { return nextSequence - nextToDeliver < (uint64_t) maxInFlight || stopping; });
+        if (stopping) {
+            return NOT_SUBMITTED;
+        }
+        sequence = nextSequence++;
+    }
+
+    pool.addJob([this, sequence, job = std::move(job)]() mutable {
+        runJob(sequence, job);
+    });
+    return sequence;
+}
+
+void FrameProducerPool::runJob(uint64_t sequence, Job& job) {
+    Frame frame = job();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return;
+        }
+        const size_t slot = sequence % maxInFlight;
+        finished[slot] = std::move(frame);
+        isFinished[slot] = true;
+        if (delivering) {
+            // The delivering thread will pick this frame up when it gets to it
+            return;
+        }
+        delivering = true;
+    }
+
+    deliver();
+}
+
+void FrameProducerPool::deliver() {
+    while (true) {
+        Frame frame;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const size_t slot = nextToDeliver % maxInFlight;
+            if (stopping || !isFinished[slot]) {
+                delivering = false;
+                break;
+            }
+            frame = std::move(finished[slot]);
+            isFinished[slot] = false;
+        }
+
+        // Pushed outside the lock since the queue may block until the consumer catches up
+        queue.push(std::move(frame));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            nextToDeliver++;
+        }
+        spaceAvailable.notify_all();
+        allDelivered.notify_all();
+    }
+}
+
+void FrameProducerPool::waitUntilDelivered() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDelivered.wait(lock, [this]() { return nextToDeliver == nextSequence || stopping; });
+}
+
+int FrameProducerPool::getNumInFlight() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int) (nextSequence - nextToDeliver);
+}
+
+} // namespace osci
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "osci_BlockingQueue.h"
+
+namespace osci {
+
+// Runs frame-producing jobs on several threads and pushes their frames into a
+// BlockingQueue strictly in the order the jobs were submitted. At most
+// maxInFlight jobs can be submitted but not yet delivered, which bounds how many
+// finished frames wait for a slower one ahead of them.
+//
+// To shut down while the consumer isn't popping, kill() the queue before
+// destroying the pool so that delivery can't block forever.
+class FrameProducerPool {
+public:
+    using Job = std::function<Frame()>;
+
+    // Returned by submit() once the pool is shutting down and won't run the job
+    static constexpr uint64_t NOT_SUBMITTED = std::numeric_limits<uint64_t>::max();
+
+    FrameProducerPool(BlockingQueue& queue, int numThreads, int maxInFlight);
+    ~FrameProducerPool();
+
+    // Queues a job and returns its sequence number. Blocks while maxInFlight
+    // jobs are waiting to be delivered. Returns NOT_SUBMITTED without queueing
+    // the job if the pool is being destroyed.
+    uint64_t submit(Job job);
+    // Blocks until every submitted frame has been pushed into the queue.
+    void waitUntilDelivered();
+
+    int getNumInFlight();
+
+private:
+    void runJob(uint64_t sequence, Job& job);
+    void deliver();
+
+    BlockingQueue& queue;
+    const int maxInFlight;
+
+    std::mutex mutex;
+    std::condition_variable spaceAvailable;
+    std::condition_variable allDelivered;
+
+    uint64_t nextSequence = 0;
+    uint64_t nextToDeliver = 0;
+    // Finished frames waiting for earlier ones, indexed by sequence % maxInFlight
+    std::vector<Frame> finished;
+    std::vector<bool> isFinished;
+    // Only one thread pushes into the queue at a time, which keeps frames in order
+    bool delivering = false;
+    bool stopping = false;
+
+    juce::ThreadPool pool;
+
+    FrameProducerPool(const FrameProducerPool&) = delete;
+    FrameProducerPool& operator=(const FrameProducerPool&) = delete;
+};
+
+} // namespace osci
@@ -21,6 +21,11 @@ void Effect::animateValues(int numSamples, const juce::AudioBuffer<float>* volum
             animatedValuesBuffer[i].resize(blockSize);
         }
     }
+    if (constantForBlock.size() != numParameters) {
+        constantForBlock.assign(numParameters, 0);
+        constantValues.assign(numParameters, 0.0f);
+        constantSamples.assign(numParameters, 0);
+    }
 
     // Lazy-initialise smoothedState so that external modulation writing to
     // actualValues (via processBlock / publishAnimatedToActual) doesn't
@@ -67,28 +72,45 @@ void Effect::animateValues(int numSamples, const juce::AudioBuffer<float>* volum
             // which is immune to external modulation overwriting actualValues)
             float current = smoothedState[paramIdx];
             
-            // Process all samples in block
-            for (size_t i = 0; i < blockSize; i++) {
-                float target;
-                if (useSidechain) {
-                    float volume = (volumeBuffer != nullptr && static_cast<int>(i) < volumeBuffer->getNumSamples()) 
-                        ? volumeBuffer->getSample(0, static_cast<int>(i)) : 1.0f;
-                    target = volume * range + minValue;
-                } else {
-                    target = staticTarget;
+            // Settled: the target is fixed and smoothing will snap to it on the first
+            // sample, so the whole block holds the target. The buffer is only filled
+            // if it doesn't already hold it from an earlier block.
+            const bool settled = !useSidechain && (instantSmoothing || std::abs(current - staticTarget) < EFFECT_SNAP_THRESHOLD);
+            if (settled) {
+                if (constantSamples[paramIdx] < blockSize || constantValues[paramIdx] != staticTarget) {
+                    juce::FloatVectorOperations::fill(outBuffer, staticTarget, blockSizeInt);
+                    constantValues[paramIdx] = staticTarget;
+                    constantSamples[paramIdx] = blockSize;
                 }
-                
-                if (instantSmoothing) {
-                    current = target;
-                } else {
-                    const float diff = std::abs(current - target);
-                    if (diff < EFFECT_SNAP_THRESHOLD) {
+                constantForBlock[paramIdx] = 1;
+                current = staticTarget;
+            } else {
+                constantForBlock[paramIdx] = 0;
+                constantSamples[paramIdx] = 0;
+
+                // Process all samples in block
+                for (size_t i = 0; i < blockSize; i++) {
+                    float target;
+                    if (useSidechain) {
+                        float volume = (volumeBuffer != nullptr && static_cast<int>(i) < volumeBuffer->getNumSamples()) 
+                            ? volumeBuffer->getSample(0, static_cast<int>(i)) : 1.0f;
+                        target = volume * range + minValue;
+                    } else {
+                        target = staticTarget;
+                    }
+                    
+                    if (instantSmoothing) {
                         current = target;
                     } else {
-                        current = std::fma(smoothingWeight, (target - current), current);
+                        const float diff = std::abs(current - target);
+                        if (diff < EFFECT_SNAP_THRESHOLD) {
+                            current = target;
+                        } else {
+                            current = std::fma(smoothingWeight, (target - current), current);
+                        }
                     }
+                    outBuffer[i] = current;
                 }
-                outBuffer[i] = current;
             }
             
             // Store final value for next block
@@ -97,6 +119,8 @@ void Effect::animateValues(int numSamples, const juce::AudioBuffer<float>* volum
             
         } else {
             // ===== LFO PATH =====
+            constantForBlock[paramIdx] = 0;
+            constantSamples[paramIdx] = 0;
             
             // Compute LFO bounds once per block
             float lfoMin = minValue;
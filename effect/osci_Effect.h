@@ -50,6 +50,7 @@ public:
 	const juce::String getName() const override;
     void prepareToPlay(double sr, int samplesPerBlock) override {
         sampleRate = static_cast<float>(sr);
+        maxBlockSize = samplesPerBlock;
 
         // Pre-allocate animated value buffers so animateValues() never resizes
         const size_t numParams = parameters.size();
@@ -60,6 +61,9 @@ public:
         smoothedState.resize(numParams);
         for (size_t i = 0; i < numParams; i++)
             smoothedState[i] = parameters[i]->getValueUnnormalised();
+        constantForBlock.assign(numParams, 0);
+        constantValues.assign(numParams, 0.0f);
+        constantSamples.assign(numParams, 0);
 
         onPrepareToPlay();
     }
@@ -149,6 +153,12 @@ public:
                animatedValuesBuffer[0].size() >= numSamples;
     }
 
+    // True when a parameter has settled, so every animated value in the current block
+    // is the same and consumers can read it once instead of per sample.
+    inline bool isConstantForBlock(size_t paramIndex) const {
+        return paramIndex < constantForBlock.size() && constantForBlock[paramIndex] != 0;
+    }
+
     // Publish the last sample from the animated buffer into actualValues.
     // Used for effects whose animated buffers are externally modulated
     // but which don't go through processBlock() (e.g. shader parameters).
@@ -175,10 +185,15 @@ public:
 
     // Get a writable pointer to the animated values buffer for external modulation (e.g. global LFOs).
     // Returns nullptr if the buffer is not populated for the given parameter index.
+    // The values may be changed, so the parameter is no longer treated as constant.
     inline float* getAnimatedValuesWritePointer(size_t paramIndex, size_t minSamples = 0) {
         if (paramIndex < animatedValuesBuffer.size() &&
             !animatedValuesBuffer[paramIndex].empty() &&
             animatedValuesBuffer[paramIndex].size() >= minSamples) {
+            if (paramIndex < constantForBlock.size()) {
+                constantForBlock[paramIndex] = 0;
+                constantSamples[paramIndex] = 0;
+            }
             return animatedValuesBuffer[paramIndex].data();
         }
         return nullptr;
@@ -210,6 +225,8 @@ protected:
     std::vector<std::atomic<float>> actualValues;
 	std::atomic<int> precedence{-1};
     float sampleRate = 192000;
+    // Block size from the last prepareToPlay(), for sizing buffers in onPrepareToPlay()
+    int maxBlockSize = 0;
 
     bool premiumOnly = false;
 
@@ -225,6 +242,13 @@ protected:
     // modulation writing to actualValues (via processBlock / publishAnimatedToActual)
     // does not pollute the smoothing start point.
     std::vector<float> smoothedState;
+
+    // Per-parameter settled state from animateValues(). constantSamples is how many
+    // samples of the animated buffer are known to hold constantValues, so settled
+    // parameters only refill their buffer when the value or block size changes.
+    std::vector<uint8_t> constantForBlock;
+    std::vector<float> constantValues;
+    std::vector<size_t> constantSamples;
 };
 
 } // namespace osci
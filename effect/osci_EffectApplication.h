@@ -2,6 +2,7 @@
 #include "../shape/osci_Point.h"
 #include <JuceHeader.h>
 #include <memory>
+#include <span>
 
 #define VERSION_HINT 2
 
@@ -15,6 +16,46 @@ public:
 	virtual ~EffectApplication() = default;
 
 	virtual Point apply(int index, Point input, Point externalInput, const std::vector<std::atomic<float>>& values, float sampleRate, float frequency) = 0;
+
+	// A run of samples for applyBlock(), processed in place. Channels are x, y, z, r, g, b,
+	// as many as the buffer has, and every array below holds numSamples values.
+	struct BlockContext {
+		float* const* channels = nullptr;
+		int numChannels = 0;
+		int numSamples = 0;
+		// Index of the first sample within the audio block, i.e. the index apply() would get
+		int startIndex = 0;
+		// Animated values of each parameter, one array per parameter
+		const float* const* values = nullptr;
+		// Nonzero where a parameter is settled, so values[i][0] holds for every sample
+		const uint8_t* constant = nullptr;
+		int numValues = 0;
+		std::span<const float> frequency;
+		// Empty when there's no external input. Mono input is used for both.
+		std::span<const float> externalX;
+		std::span<const float> externalY;
+		float sampleRate = 0;
+	};
+
+	// Return true if this application implements applyBlock(), so SimpleEffect uses it
+	// instead of calling apply() per sample.
+	virtual bool supportsBlockProcessing() const { return false; }
+	// Optional block form of apply(), so effects avoid a virtual call per sample and can
+	// vectorise their inner loops. Blocks are split at frame starts so onFrameStart() is
+	// still called in order, and colour is restored afterwards unless modifiesColour()
+	// returns true.
+	virtual void applyBlock(const BlockContext& context) { jassertfalse; }
+
+	// Return true to be called through applyWithValues() instead of apply(), which
+	// gets this sample's parameter values as plain floats. This saves SimpleEffect
+	// storing every value to an atomic on every sample.
+	virtual bool readsValuesDirectly() const { return false; }
+	// Same as apply(), with values[i] the current value of parameter i. Must be
+	// overridden by applications that return true from readsValuesDirectly().
+	virtual Point applyWithValues(int index, Point input, Point externalInput, const float* values, float sampleRate, float frequency) {
+		jassertfalse;
+		return input;
+	}
 	// Optional hook called at the start of a ShapeVoice frame (i.e. cycle boundary) when available.
 	// Default no-op.
 	virtual void onFrameStart() {}
@@ -0,0 +1,43 @@
+#include "osci_EffectChain.h"
+
+namespace osci {
+
+void EffectChain::setEffects(const std::vector<SimpleEffect*>& newEffects) {
+	effects.assign(newEffects.begin(), newEffects.end());
+	std::stable_sort(effects.begin(), effects.end(), [](SimpleEffect* a, SimpleEffect* b) {
+		return a->getPrecedence() < b->getPrecedence();
+	});
+}
+
+void EffectChain::processBlock(juce::AudioBuffer<float>& buffer,
+                               juce::AudioBuffer<float>* externalInput,
+                               juce::AudioBuffer<float>* volumeInput,
+                               juce::AudioBuffer<float>* frequencyInput,
+                               juce::AudioBuffer<float>* frameSyncInput) {
+	const int numSamples = buffer.getNumSamples();
+
+	for (auto* effect : effects) {
+		effect->setExternalInput(externalInput);
+		effect->setVolumeInput(volumeInput);
+		effect->setFrequencyInput(frequencyInput);
+		effect->setFrameSyncInput(frameSyncInput);
+		effect->beginBlock(numSamples);
+	}
+
+	for (int start = 0; start < numSamples; start += TILE_SIZE) {
+		const int tileSize = std::min(TILE_SIZE, numSamples - start);
+		for (auto* effect : effects) {
+			effect->processRange(buffer, start, tileSize);
+		}
+	}
+
+	for (auto* effect : effects) {
+		effect->endBlock();
+		effect->setExternalInput(nullptr);
+		effect->setVolumeInput(nullptr);
+		effect->setFrequencyInput(nullptr);
+		effect->setFrameSyncInput(nullptr);
+	}
+}
+
+} // namespace osci
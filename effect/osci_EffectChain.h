@@ -0,0 +1,31 @@
+#pragma once
+#include <JuceHeader.h>
+#include "osci_SimpleEffect.h"
+
+namespace osci {
+
+// Runs a chain of SimpleEffects over a block a tile of samples at a time, rather
+// than each effect over the whole block in turn, so the samples stay in cache
+// between effects. Each effect still sees its samples in order, so frame starts
+// and colour handling behave as they do in SimpleEffect::processBlock.
+class EffectChain {
+public:
+	static constexpr int TILE_SIZE = 64;
+
+	// Sets the effects to run, in order of precedence. Effects are not owned and
+	// must outlive the chain or the next call to setEffects().
+	void setEffects(const std::vector<SimpleEffect*>& newEffects);
+	const std::vector<SimpleEffect*>& getEffects() const { return effects; }
+
+	// Call animateValues() on each effect first, as for processBlock().
+	void processBlock(juce::AudioBuffer<float>& buffer,
+	                  juce::AudioBuffer<float>* externalInput,
+	                  juce::AudioBuffer<float>* volumeInput,
+	                  juce::AudioBuffer<float>* frequencyInput,
+	                  juce::AudioBuffer<float>* frameSyncInput = nullptr);
+
+private:
+	std::vector<SimpleEffect*> effects;
+};
+
+} // namespace osci
@@ -12,6 +12,7 @@ public:
         for (int i = 0; i < parameters.size(); i++) {
             actualValues[i] = parameters[i]->getValueUnnormalised();
         }
+        allocateParameterScratch();
     }
 
     SimpleEffect(std::shared_ptr<EffectApplication> effectApplication, EffectParameter* parameter) : SimpleEffect(effectApplication, std::vector<EffectParameter*>{parameter}) {}
@@ -22,6 +23,7 @@ public:
         for (int i = 0; i < parameters.size(); i++) {
             actualValues[i] = parameters[i]->getValueUnnormalised();
         }
+        allocateParameterScratch();
     }
 
     SimpleEffect(EffectApplicationType application, EffectParameter* parameter) : SimpleEffect(application, std::vector<EffectParameter*>{parameter}) {}
@@ -34,26 +36,29 @@ public:
         if (effectApplication != nullptr) {
             effectApplication->prepareToPlay(sampleRate);
         }
+
+        // Scratch space for applyBlockToRange(), so processing never allocates
+        const size_t blockSize = static_cast<size_t>(std::max(maxBlockSize, 0));
+        frequencyScratch.resize(blockSize);
+        colourScratch.resize(3 * blockSize);
     }
 
 	void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
-        const int numChannels = buffer.getNumChannels();
-        const int numSamples = buffer.getNumSamples();
-        const bool hasX = numChannels >= 1; // ch0 -> X
-        const bool hasY = numChannels >= 2; // ch1 -> Y
-        const bool hasZ = numChannels >= 3; // ch2 -> Z
-        const bool hasR = numChannels >= 4; // ch3 -> R
-        const bool hasG = numChannels >= 5; // ch4 -> G
-        const bool hasB = numChannels >= 6; // ch5 -> B
+        beginBlock(buffer.getNumSamples());
+        processRange(buffer, 0, buffer.getNumSamples());
+        endBlock();
+    }
 
-        const bool useFunction = application != nullptr;
-        const bool useClass = effectApplication != nullptr;
-        
+    // Prepares to process a block of numSamples samples in ranges with processRange(),
+    // as EffectChain does to run a chain of effects a tile of samples at a time.
+    // Call endBlock() after the last range.
+    void beginBlock(int numSamples) {
+        currentBlockSize = numSamples;
         // Get the source for animated values (either from our parent if we're a clone, or ourselves)
         const Effect* valueSource = animatedValuesSource ? animatedValuesSource : this;
-        
+
         // Check if pre-animated values exist - if not, log warning once and use static values as fallback
-        const bool hasPreAnimatedValues = valueSource->hasAnimatedValuesForBlock(static_cast<size_t>(numSamples));
+        hasPreAnimatedValues = valueSource->hasAnimatedValuesForBlock(static_cast<size_t>(numSamples));
         if (!hasPreAnimatedValues) {
             DBG("Warning: Effect '" + getId() + "' is missing pre-animated values! Using static parameter values as fallback.");
             // Cache static parameter values once (fallback path)
@@ -61,76 +66,146 @@ public:
                 actualValues[p] = parameters[p]->getValueUnnormalised();
             }
         }
+    }
+
+    // Publishes the values at the last sample of the block to actualValues for the UI,
+    // once per block however many ranges it was processed in.
+    void endBlock() {
+        if (hasPreAnimatedValues && currentBlockSize > 0) {
+            publishActualValues(animatedValuesSource ? *animatedValuesSource : *this, currentBlockSize - 1);
+        }
+    }
 
-        for (int i = 0; i < numSamples; i++) {
-            if (useClass && frameSyncInput != nullptr && i < frameSyncInput->getNumSamples()) {
-                const float sync = frameSyncInput->getSample(0, i);
-                if (sync > 0.5f) {
+    // Processes numSamples samples from start in the block passed to beginBlock().
+    // Sample indices, including those into the inputs, are relative to the block.
+    void processRange(juce::AudioBuffer<float>& buffer, int start, int numSamples) {
+        const int numChannels = buffer.getNumChannels();
+        const int end = start + numSamples;
+        // Channels are x, y, z, r, g, b, in that order
+        const bool hasR = numChannels >= 4;
+
+        const bool useFunction = application != nullptr;
+        const bool useClass = effectApplication != nullptr;
+
+        const Effect* valueSource = animatedValuesSource ? animatedValuesSource : this;
+
+        // Use the application's block form when it has one, one run per frame
+        if (useClass && hasPreAnimatedValues && effectApplication->supportsBlockProcessing() && prepareBlockValues(*valueSource, end, numSamples)) {
+            while (start < end) {
+                if (isFrameStart(start)) {
                     effectApplication->onFrameStart();
                 }
+                int runEnd = start + 1;
+                while (runEnd < end && !isFrameStart(runEnd)) {
+                    runEnd++;
+                }
+                applyBlockToRange(buffer, start, runEnd - start);
+                start = runEnd;
             }
+            return;
+        }
 
-            // Copy pre-computed values from source to actualValues
-            if (hasPreAnimatedValues) {
-                for (size_t p = 0; p < parameters.size(); p++) {
-                    actualValues[p] = valueSource->getAnimatedValue(p, static_cast<size_t>(i));
-                }
+        // Per-sample path. Samples are copied out of the buffer a tile at a time so the
+        // inner loop reads and writes plain arrays, with missing channels reading as zero.
+        const bool restoreColour = useClass && !effectApplication->modifiesColour();
+        const int numTileChannels = std::min(numChannels, 6);
+        const float* frequencies = frequencyInput != nullptr ? frequencyInput->getReadPointer(0) : nullptr;
+        const int numFrequencies = frequencyInput != nullptr ? frequencyInput->getNumSamples() : 0;
+        const int numExternalChannels = externalInput != nullptr ? externalInput->getNumChannels() : 0;
+        const float* externalX = numExternalChannels > 0 ? externalInput->getReadPointer(0) : nullptr;
+        const float* externalY = numExternalChannels > 1 ? externalInput->getReadPointer(1) : externalX;
+        float tile[6][TILE_SIZE];
+
+        // The application reads each sample's values from sampleValues if it reads values
+        // directly, and otherwise from sampleAtomics. actualValues is only published for
+        // the UI by endBlock().
+        const bool useValueView = useClass && effectApplication->readsValuesDirectly();
+
+        // Settled parameters are set once for the range, so only the rest are copied per
+        // sample. Parameters missing their animated values fall back to actualValues, as
+        // getAnimatedValue() does.
+        varyingParameters.clear();
+        for (size_t p = 0; p < parameters.size(); p++) {
+            const float* values = hasPreAnimatedValues ? valueSource->getAnimatedValuesReadPointer(p, static_cast<size_t>(end)) : nullptr;
+            if (values != nullptr && !valueSource->isConstantForBlock(p)) {
+                valuePointers[p] = values;
+                varyingParameters.push_back(p);
+            } else {
+                const float value = hasPreAnimatedValues ? valueSource->getAnimatedValue(p, static_cast<size_t>(start)) : actualValues[p].load(std::memory_order_relaxed);
+                sampleValues[p] = value;
+                sampleAtomics[p].store(value, std::memory_order_relaxed);
             }
-            // Note: if no pre-animated values, actualValues already set to static values above
-            
-            // Get frequency from frequency buffer (defaults to 220Hz if not provided)
-            float frequency = 220.0f;
-            if (frequencyInput != nullptr && i < frequencyInput->getNumSamples()) {
-                frequency = frequencyInput->getSample(0, i);
+        }
+
+        for (int tileStart = start; tileStart < end; tileStart += TILE_SIZE) {
+            const int tileSize = std::min(TILE_SIZE, end - tileStart);
+            for (int c = 0; c < 6; c++) {
+                if (c < numTileChannels) {
+                    juce::FloatVectorOperations::copy(tile[c], buffer.getReadPointer(c, tileStart), tileSize);
+                } else {
+                    juce::FloatVectorOperations::fill(tile[c], 0.0f, tileSize);
+                }
             }
 
-            const float x = hasX ? buffer.getSample(0, i) : 0.0f;
-            const float y = hasY ? buffer.getSample(1, i) : 0.0f;
-            const float z = hasZ ? buffer.getSample(2, i) : 0.0f;
-            const float cr = hasR ? buffer.getSample(3, i) : 0.0f;
-            const float cg = hasG ? buffer.getSample(4, i) : 0.0f;
-            const float cb = hasB ? buffer.getSample(5, i) : 0.0f;
-
-            const bool colourPresent = hasR && cr >= 0.0f;
-            Point point = colourPresent ? Point(x, y, z, cr, cg, cb) : Point(x, y, z);
-
-            // Save original colour state in case the effect doesn't handle it
-            const float origR = point.r;
-            const float origG = point.g;
-            const float origB = point.b;
-
-            if (useFunction) {
-                point = application(i, point, actualValues, sampleRate, frequency);
-            } else if (useClass) {
-                if (externalInput != nullptr) {
-                    Point externalPoint;
-                    if (externalInput->getNumChannels() > 1) {
-                        externalPoint.x = externalInput->getSample(0, i);
-                        externalPoint.y = externalInput->getSample(1, i);
-                    } else if (externalInput->getNumChannels() > 0) {
-                        externalPoint.x = externalInput->getSample(0, i);
-                        externalPoint.y = externalInput->getSample(0, i);
-                    }
+            for (int t = 0; t < tileSize; t++) {
+                const int i = tileStart + t;
+                if (useClass && isFrameStart(i)) {
+                    effectApplication->onFrameStart();
+                }
 
-                    point = effectApplication->apply(i, point, externalPoint, actualValues, sampleRate, frequency);
+                // Copy pre-computed values from source to the values the application reads
+                if (useValueView) {
+                    for (size_t p : varyingParameters) {
+                        sampleValues[p] = valuePointers[p][i];
+                    }
                 } else {
-                    point = effectApplication->apply(i, point, Point(), actualValues, sampleRate, frequency);
+                    for (size_t p : varyingParameters) {
+                        sampleAtomics[p].store(valuePointers[p][i], std::memory_order_relaxed);
+                    }
+                }
+
+                // Get frequency from frequency buffer (defaults to 220Hz if not provided)
+                const float frequency = i < numFrequencies ? frequencies[i] : 220.0f;
+
+                const bool colourPresent = hasR && tile[3][t] >= 0.0f;
+                Point point = colourPresent ? Point(tile[0][t], tile[1][t], tile[2][t], tile[3][t], tile[4][t], tile[5][t]) : Point(tile[0][t], tile[1][t], tile[2][t]);
+
+                if (useFunction) {
+                    point = application(i, point, sampleAtomics, sampleRate, frequency);
+                } else if (useClass) {
+                    const Point externalPoint = externalX != nullptr ? Point(externalX[i], externalY[i]) : Point();
+                    if (useValueView) {
+                        point = effectApplication->applyWithValues(i, point, externalPoint, sampleValues.data(), sampleRate, frequency);
+                    } else {
+                        point = effectApplication->apply(i, point, externalPoint, sampleAtomics, sampleRate, frequency);
+                    }
+                }
+
+                tile[0][t] = point.x;
+                tile[1][t] = point.y;
+                tile[2][t] = point.z;
+                // Colour the effect doesn't handle is restored for the whole tile below
+                if (!restoreColour) {
+                    tile[3][t] = point.r;
+                    tile[4][t] = point.g;
+                    tile[5][t] = point.b;
                 }
+            }
 
-                // Restore colour for effects that don't intentionally modify it
-                if (!effectApplication->modifiesColour()) {
-                    point.r = origR;
-                    point.g = origG;
-                    point.b = origB;
+            // Restore colour for effects that don't intentionally modify it. Samples
+            // without colour come out as a Point without colour would.
+            if (restoreColour && hasR) {
+                for (int t = 0; t < tileSize; t++) {
+                    const bool colourPresent = tile[3][t] >= 0.0f;
+                    tile[3][t] = colourPresent ? tile[3][t] : -1.0f;
+                    tile[4][t] = colourPresent ? tile[4][t] : -1.0f;
+                    tile[5][t] = colourPresent ? tile[5][t] : -1.0f;
                 }
             }
 
-            if (hasX) buffer.setSample(0, i, point.x);
-            if (hasY) buffer.setSample(1, i, point.y);
-            if (hasZ) buffer.setSample(2, i, point.z);
-            if (hasR) buffer.setSample(3, i, point.r);
-            if (hasG) buffer.setSample(4, i, point.g);
-            if (hasB) buffer.setSample(5, i, point.b);
+            for (int c = 0; c < numTileChannels; c++) {
+                juce::FloatVectorOperations::copy(buffer.getWritePointer(c, tileStart), tile[c], tileSize);
+            }
         }
     }
 
@@ -167,6 +242,108 @@ public:
     }
 
 private:
+    static constexpr int TILE_SIZE = 64;
+
+    // Sizes the scratch space that depends only on the number of parameters
+    void allocateParameterScratch() {
+        valueBuffers.resize(parameters.size());
+        valuePointers.resize(parameters.size());
+        constantFlags.resize(parameters.size());
+        sampleValues.resize(parameters.size());
+        sampleAtomics = std::vector<std::atomic<float>>(parameters.size());
+        varyingParameters.reserve(parameters.size());
+    }
+
+    // Publishes the values at one sample of the block for the UI
+    void publishActualValues(const Effect& valueSource, int sample) {
+        for (size_t p = 0; p < parameters.size(); p++) {
+            actualValues[p].store(valueSource.getAnimatedValue(p, static_cast<size_t>(sample)), std::memory_order_relaxed);
+        }
+    }
+
+    bool isFrameStart(int i) const {
+        return frameSyncInput != nullptr && i < frameSyncInput->getNumSamples() && frameSyncInput->getSample(0, i) > 0.5f;
+    }
+
+    // Finds every parameter's animated values for applyBlockToRange(). Returns false,
+    // so the range is processed per sample, if any are missing or the range is larger
+    // than the scratch space allocated in onPrepareToPlay().
+    bool prepareBlockValues(const Effect& valueSource, int end, int numSamples) {
+        if (valueBuffers.size() < parameters.size() || frequencyScratch.size() < static_cast<size_t>(numSamples)) {
+            return false;
+        }
+        for (size_t p = 0; p < parameters.size(); p++) {
+            valueBuffers[p] = valueSource.getAnimatedValuesReadPointer(p, static_cast<size_t>(end));
+            if (valueBuffers[p] == nullptr) {
+                return false;
+            }
+            constantFlags[p] = valueSource.isConstantForBlock(p) ? 1 : 0;
+        }
+        return true;
+    }
+
+    // Runs EffectApplication::applyBlock() over numSamples samples from start, after
+    // prepareBlockValues() has succeeded for the range containing them.
+    void applyBlockToRange(juce::AudioBuffer<float>& buffer, int start, int numSamples) {
+        const int numChannels = std::min(buffer.getNumChannels(), 6);
+        const size_t size = static_cast<size_t>(numSamples);
+
+        for (size_t p = 0; p < parameters.size(); p++) {
+            valuePointers[p] = valueBuffers[p] + start;
+        }
+
+        EffectApplication::BlockContext context;
+        for (int c = 0; c < numChannels; c++) {
+            channelPointers[c] = buffer.getWritePointer(c, start);
+        }
+        context.channels = channelPointers;
+        context.numChannels = numChannels;
+        context.numSamples = numSamples;
+        context.startIndex = start;
+        context.values = valuePointers.data();
+        context.constant = constantFlags.data();
+        context.numValues = static_cast<int>(parameters.size());
+        context.sampleRate = sampleRate;
+
+        // Frequency defaults to 220Hz past the end of the frequency buffer, as in the per-sample path
+        const int numFrequencies = frequencyInput != nullptr ? juce::jlimit(0, numSamples, frequencyInput->getNumSamples() - start) : 0;
+        if (numFrequencies == numSamples) {
+            context.frequency = std::span<const float>(frequencyInput->getReadPointer(0, start), size);
+        } else {
+            if (numFrequencies > 0) {
+                juce::FloatVectorOperations::copy(frequencyScratch.data(), frequencyInput->getReadPointer(0, start), numFrequencies);
+            }
+            juce::FloatVectorOperations::fill(frequencyScratch.data() + numFrequencies, 220.0f, numSamples - numFrequencies);
+            context.frequency = std::span<const float>(frequencyScratch.data(), size);
+        }
+
+        if (externalInput != nullptr && externalInput->getNumChannels() > 0) {
+            context.externalX = std::span<const float>(externalInput->getReadPointer(0, start), size);
+            context.externalY = std::span<const float>(externalInput->getReadPointer(externalInput->getNumChannels() > 1 ? 1 : 0, start), size);
+        }
+
+        const bool restoreColour = numChannels > 3 && !effectApplication->modifiesColour();
+        if (restoreColour) {
+            for (int c = 3; c < numChannels; c++) {
+                juce::FloatVectorOperations::copy(colourScratch.data() + (c - 3) * size, channelPointers[c], numSamples);
+            }
+        }
+
+        effectApplication->applyBlock(context);
+
+        // Samples without colour come out as a Point without colour would, as in the per-sample path
+        if (restoreColour) {
+            const float* savedR = colourScratch.data();
+            for (int c = 3; c < numChannels; c++) {
+                const float* saved = colourScratch.data() + (c - 3) * size;
+                float* channel = channelPointers[c];
+                for (int i = 0; i < numSamples; i++) {
+                    channel[i] = savedR[i] >= 0.0f ? saved[i] : -1.0f;
+                }
+            }
+        }
+    }
+
 	EffectApplicationType application;
 	std::shared_ptr<EffectApplication> effectApplication;
     // Pointer to the source effect that has pre-computed animated values.
@@ -175,6 +352,23 @@ private:
     // In practice, this is the global effect in toggleableEffects which
     // persists for the lifetime of the processor.
     const Effect* animatedValuesSource = nullptr;
+    // Set by beginBlock()
+    bool hasPreAnimatedValues = false;
+    int currentBlockSize = 0;
+
+    // Scratch space for processRange() and applyBlockToRange(), sized on construction
+    // and in onPrepareToPlay() so processing never allocates
+    float* channelPointers[6] = {};
+    std::vector<const float*> valueBuffers;
+    std::vector<const float*> valuePointers;
+    std::vector<float> sampleValues;
+    // Values passed to apply() and function applications, kept apart from actualValues
+    // so the UI only sees a store per parameter per block
+    std::vector<std::atomic<float>> sampleAtomics;
+    std::vector<size_t> varyingParameters;
+    std::vector<uint8_t> constantFlags;
+    std::vector<float> frequencyScratch;
+    std::vector<float> colourScratch;
 };
 
 } // namespace osci
@@ -0,0 +1,62 @@
+#include "osci_Frame.h"
+#include "../shape/osci_Point.h"
+#include "../shape/osci_Line.h"
+#include "../shape/osci_CubicBezierCurve.h"
+#include "../shape/osci_CircleArc.h"
+
+namespace osci {
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+static void hashBytes(uint64_t& hash, const void* data, size_t size) {
+	auto bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+}
+
+// What a shape draws, independent of how it was allocated, e.g. as a plain Line
+// or as a FrameArena shape derived from one.
+enum class ShapeKind : uint8_t {
+	Line,
+	CubicBezierCurve,
+	CircleArc,
+	Point,
+	Other,
+};
+
+static ShapeKind kindOf(Shape& shape) {
+	if (dynamic_cast<Line*>(&shape) != nullptr) {
+		return ShapeKind::Line;
+	}
+	if (dynamic_cast<CubicBezierCurve*>(&shape) != nullptr) {
+		return ShapeKind::CubicBezierCurve;
+	}
+	if (dynamic_cast<CircleArc*>(&shape) != nullptr) {
+		return ShapeKind::CircleArc;
+	}
+	if (dynamic_cast<Point*>(&shape) != nullptr) {
+		return ShapeKind::Point;
+	}
+	return ShapeKind::Other;
+}
+
+uint64_t hashFrame(const Frame& frame) {
+	static constexpr float progress[] = { 0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f };
+
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (auto& shape : frame) {
+		const ShapeKind kind = kindOf(*shape);
+		hashBytes(hash, &kind, sizeof(kind));
+
+		for (float t : progress) {
+			Point point = shape->nextVector(t);
+			const float coordinates[3] = { point.x, point.y, point.z };
+			hashBytes(hash, coordinates, sizeof(coordinates));
+		}
+	}
+	return hash;
+}
+
+} // namespace osci
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../shape/osci_Shape.h"
+
+namespace osci {
+
+typedef std::vector<std::unique_ptr<osci::Shape>> Frame;
+
+// FNV-1a hash of each shape's kind and the points it draws at a few fixed
+// progress values, which pins down lines, cubic curves and arcs exactly. Kinds
+// are geometric, so the same frame hashes the same however its shapes were
+// allocated. Used to key caches of work derived from a frame.
+uint64_t hashFrame(const Frame& frame);
+
+} // namespace osci
@@ -0,0 +1,91 @@
+#include "osci_FrameArena.h"
+#include <JuceHeader.h>
+
+namespace osci {
+
+// Prefixes every shape allocation so deallocation knows which arena it came
+// from. Padded to keep the shape itself 16-byte aligned.
+struct alignas(16) ShapeAllocationHeader {
+	FrameArena* arena;
+};
+
+thread_local FrameArena* FrameArena::current = nullptr;
+
+FrameArena::FrameArena(size_t blockSize) : blockSize(blockSize) {}
+
+FrameArena::~FrameArena() {
+	// Shapes from this arena are still alive and would be left dangling
+	jassert(liveShapes.load() == 0);
+	jassert(activeScopes == 0);
+}
+
+FrameArena::Scope::Scope(FrameArena& arena) : arena(arena), previous(current) {
+	current = &arena;
+	arena.activeScopes++;
+}
+
+FrameArena::Scope::~Scope() {
+	current = previous;
+	arena.activeScopes--;
+}
+
+bool FrameArena::isIdle() const {
+	return activeScopes == 0 && liveShapes.load(std::memory_order_acquire) == 0;
+}
+
+void FrameArena::rewind() {
+	currentBlock = 0;
+	offset = 0;
+}
+
+void* FrameArena::allocate(size_t size) {
+	size = (size + alignof(ShapeAllocationHeader) - 1) & ~(alignof(ShapeAllocationHeader) - 1);
+
+	while (currentBlock < blocks.size()) {
+		Block& block = blocks[currentBlock];
+		if (offset + size <= block.size) {
+			void* memory = block.data.get() + offset;
+			offset += size;
+			return memory;
+		}
+		currentBlock++;
+		offset = 0;
+	}
+
+	const size_t newBlockSize = std::max(blockSize, size);
+	blocks.push_back({ std::unique_ptr<char[]>(new char[newBlockSize]), newBlockSize });
+	currentBlock = blocks.size() - 1;
+	offset = size;
+	return blocks.back().data.get();
+}
+
+void* FrameArena::allocateShape(size_t size) {
+	// Nothing from the arena is alive, so all of its memory can be reused
+	if (liveShapes.fetch_add(1, std::memory_order_acq_rel) == 0) {
+		rewind();
+	}
+
+	auto header = static_cast<ShapeAllocationHeader*>(allocate(sizeof(ShapeAllocationHeader) + size));
+	header->arena = this;
+	return header + 1;
+}
+
+void FrameArena::deallocateShape(void* pointer) {
+	if (pointer == nullptr) {
+		return;
+	}
+	ShapeAllocationHeader* header = static_cast<ShapeAllocationHeader*>(pointer) - 1;
+	header->arena->liveShapes.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+FrameArena& FrameArenaPool::acquire() {
+	for (auto& arena : arenas) {
+		if (arena->isIdle()) {
+			return *arena;
+		}
+	}
+	arenas.push_back(std::make_unique<FrameArena>(blockSize));
+	return *arenas.back();
+}
+
+} // namespace osci
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include "osci_Frame.h"
+
+namespace osci {
+
+template <typename T>
+class ArenaShape;
+
+// Bump allocator for the shapes of a frame. Shapes made with make() can go in any
+// Frame and are destroyed normally, but their memory isn't returned to the heap:
+// once every shape from the arena has been destroyed, the next make() rewinds it
+// and reuses the same memory. Shapes allocated any other way are unaffected.
+//
+// make() must only be called from one thread at a time, normally the producer.
+// Shapes may be destroyed on any thread.
+class FrameArena {
+public:
+	explicit FrameArena(size_t blockSize = 64 * 1024);
+	~FrameArena();
+
+	template <typename T, typename... Args>
+	std::unique_ptr<Shape> make(Args&&... args) {
+		static_assert(std::is_base_of_v<Shape, T>, "Only shapes can be made in a FrameArena");
+		static_assert(alignof(ArenaShape<T>) <= 16, "Arena shapes are 16-byte aligned");
+		void* memory = allocateShape(sizeof(ArenaShape<T>));
+		return std::unique_ptr<Shape>(::new (memory) ArenaShape<T>(std::forward<Args>(args)...));
+	}
+
+	// While a scope is active on a thread, clone() on a shape made in any arena
+	// makes the copy in the scope's arena. Otherwise copies go on the heap.
+	class Scope {
+	public:
+		explicit Scope(FrameArena& arena);
+		~Scope();
+
+	private:
+		FrameArena& arena;
+		FrameArena* previous;
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	// True when no scope is active and every shape has been destroyed, so the
+	// arena can be handed to a new frame.
+	bool isIdle() const;
+
+private:
+	template <typename T>
+	friend class ArenaShape;
+
+	template <typename T>
+	static std::unique_ptr<Shape> cloneShape(const T& shape) {
+		if (current != nullptr) {
+			return current->make<T>(shape);
+		}
+		return std::make_unique<T>(shape);
+	}
+
+	void* allocateShape(size_t size);
+	static void deallocateShape(void* pointer);
+	void* allocate(size_t size);
+	void rewind();
+
+	struct Block {
+		std::unique_ptr<char[]> data;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;
+	size_t blockSize;
+	size_t currentBlock = 0;
+	size_t offset = 0;
+	std::atomic<int> liveShapes = 0;
+	// Only changed by the thread that makes shapes
+	int activeScopes = 0;
+
+	static thread_local FrameArena* current;
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+};
+
+// A shape of type T living in a FrameArena. Deleting it only tells the arena,
+// and cloning it follows FrameArena::Scope.
+template <typename T>
+class ArenaShape final : public T {
+public:
+	using T::T;
+	explicit ArenaShape(const T& shape) : T(shape) {}
+
+	std::unique_ptr<Shape> clone() override {
+		return FrameArena::cloneShape<T>(*this);
+	}
+
+	static void operator delete(void* pointer) {
+		FrameArena::deallocateShape(pointer);
+	}
+};
+
+// Set of arenas for a producer that keeps several frames in flight, e.g. one
+// being built while others wait in a BlockingQueue or are being drawn.
+class FrameArenaPool {
+public:
+	explicit FrameArenaPool(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+	// Returns an idle arena, creating one if every arena still holds a frame.
+	// Must only be called from the producer thread.
+	FrameArena& acquire();
+
+private:
+	size_t blockSize;
+	std::vector<std::unique_ptr<FrameArena>> arenas;
+};
+
+} // namespace osci
@@ -0,0 +1,275 @@
+#include "osci_FrameBvh.h"
+#include <numeric>
+#include "../shape/osci_Line.h"
+
+namespace osci {
+
+// Points used to approximate curved shapes when measuring their distance to a point.
+static constexpr int NEAREST_SAMPLES = 32;
+
+static bool overlaps(const BoundingBox& a, const BoundingBox& b) {
+	return !a.isEmpty() && !b.isEmpty() && a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY;
+}
+
+static float squaredDistanceToBox(const BoundingBox& box, float x, float y) {
+	const float dx = std::max({ box.minX - x, 0.0f, x - box.maxX });
+	const float dy = std::max({ box.minY - y, 0.0f, y - box.maxY });
+	return dx * dx + dy * dy;
+}
+
+static float squaredDistanceToSegment(float x, float y, float x1, float y1, float x2, float y2) {
+	const float dx = x2 - x1, dy = y2 - y1;
+	const float lengthSquared = dx * dx + dy * dy;
+	float t = 0;
+	if (lengthSquared > 0) {
+		t = std::clamp(((x - x1) * dx + (y - y1) * dy) / lengthSquared, 0.0f, 1.0f);
+	}
+	const float ex = x1 + t * dx - x, ey = y1 + t * dy - y;
+	return ex * ex + ey * ey;
+}
+
+static float squaredDistanceToShape(Shape& shape, float x, float y) {
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		return squaredDistanceToSegment(x, y, line->x1, line->y1, line->x2, line->y2);
+	}
+
+	float xs[NEAREST_SAMPLES + 1], ys[NEAREST_SAMPLES + 1], zs[NEAREST_SAMPLES + 1];
+	shape.sampleUniform(0.0f, 1.0f / NEAREST_SAMPLES, NEAREST_SAMPLES + 1, xs, ys, zs);
+	float best = std::numeric_limits<float>::max();
+	for (int i = 0; i < NEAREST_SAMPLES; i++) {
+		best = std::min(best, squaredDistanceToSegment(x, y, xs[i], ys[i], xs[i + 1], ys[i + 1]));
+	}
+	return best;
+}
+
+FrameBvh::FrameBvh(const Frame& frame) : frame(&frame) {}
+
+void FrameBvh::setFrame(const Frame& frame) {
+	this->frame = &frame;
+	built = false;
+}
+
+void FrameBvh::invalidate() {
+	built = false;
+}
+
+void FrameBvh::build() {
+	nodes.clear();
+	order.resize(frame->size());
+	std::iota(order.begin(), order.end(), 0);
+	shapeBoxes.resize(frame->size());
+
+	std::vector<float> centreX(frame->size()), centreY(frame->size());
+	for (size_t i = 0; i < frame->size(); i++) {
+		shapeBoxes[i] = (*frame)[i]->boundingBox();
+		centreX[i] = 0.5f * (shapeBoxes[i].minX + shapeBoxes[i].maxX);
+		centreY[i] = 0.5f * (shapeBoxes[i].minY + shapeBoxes[i].maxY);
+	}
+
+	if (!order.empty()) {
+		nodes.reserve(2 * order.size() / MAX_LEAF_SHAPES + 1);
+		buildNode(0, (int) order.size(), centreX, centreY);
+	}
+	built = true;
+}
+
+int FrameBvh::buildNode(int first, int count, const std::vector<float>& centreX, const std::vector<float>& centreY) {
+	const int index = (int) nodes.size();
+	nodes.emplace_back();
+
+	BoundingBox box, centres;
+	for (int i = first; i < first + count; i++) {
+		box.expand(shapeBoxes[order[i]]);
+		centres.expand(centreX[order[i]], centreY[order[i]], 0);
+	}
+	nodes[index].box = box;
+
+	if (count <= MAX_LEAF_SHAPES) {
+		nodes[index].first = first;
+		nodes[index].count = count;
+		return index;
+	}
+
+	// Median split along the wider spread of shape centres
+	const std::vector<float>& centre = centres.width() >= centres.height() ? centreX : centreY;
+	const int half = count / 2;
+	std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count, [&centre](uint32_t a, uint32_t b) {
+		return centre[a] < centre[b];
+	});
+
+	const int left = buildNode(first, half, centreX, centreY);
+	const int right = buildNode(first + half, count - half, centreX, centreY);
+	nodes[index].left = left;
+	nodes[index].right = right;
+	return index;
+}
+
+BoundingBox FrameBvh::refitNode(int index) {
+	Node& node = nodes[index];
+	BoundingBox box;
+	if (node.isLeaf()) {
+		for (int i = node.first; i < node.first + node.count; i++) {
+			const uint32_t shape = order[i];
+			shapeBoxes[shape] = (*frame)[shape]->boundingBox();
+			box.expand(shapeBoxes[shape]);
+		}
+	} else {
+		box.expand(refitNode(node.left));
+		box.expand(refitNode(node.right));
+	}
+	nodes[index].box = box;
+	return box;
+}
+
+void FrameBvh::refit() {
+	if (!built || frame == nullptr) {
+		return;
+	}
+	if (order.size() != frame->size()) {
+		built = false;
+		return;
+	}
+	if (!nodes.empty()) {
+		refitNode(0);
+	}
+}
+
+static void scaleBox(BoundingBox& box, float x, float y, float z) {
+	if (box.isEmpty()) {
+		return;
+	}
+	box.minX *= x;
+	box.maxX *= x;
+	box.minY *= y;
+	box.maxY *= y;
+	box.minZ *= z;
+	box.maxZ *= z;
+	// Negative factors mirror the box
+	if (box.minX > box.maxX) {
+		std::swap(box.minX, box.maxX);
+	}
+	if (box.minY > box.maxY) {
+		std::swap(box.minY, box.maxY);
+	}
+	if (box.minZ > box.maxZ) {
+		std::swap(box.minZ, box.maxZ);
+	}
+}
+
+static void translateBox(BoundingBox& box, float x, float y, float z) {
+	if (box.isEmpty()) {
+		return;
+	}
+	box.minX += x;
+	box.maxX += x;
+	box.minY += y;
+	box.maxY += y;
+	box.minZ += z;
+	box.maxZ += z;
+}
+
+void FrameBvh::scale(float x, float y, float z) {
+	for (auto& node : nodes) {
+		scaleBox(node.box, x, y, z);
+	}
+	for (auto& box : shapeBoxes) {
+		scaleBox(box, x, y, z);
+	}
+}
+
+void FrameBvh::translate(float x, float y, float z) {
+	for (auto& node : nodes) {
+		translateBox(node.box, x, y, z);
+	}
+	for (auto& box : shapeBoxes) {
+		translateBox(box, x, y, z);
+	}
+}
+
+void FrameBvh::query(const BoundingBox& region, std::vector<size_t>& shapes) {
+	shapes.clear();
+	if (frame == nullptr) {
+		return;
+	}
+	if (!built) {
+		build();
+	}
+	if (nodes.empty()) {
+		return;
+	}
+
+	int stack[64];
+	int depth = 0;
+	stack[depth++] = 0;
+	while (depth > 0) {
+		const Node& node = nodes[stack[--depth]];
+		if (!overlaps(node.box, region)) {
+			continue;
+		}
+		if (node.isLeaf()) {
+			for (int i = node.first; i < node.first + node.count; i++) {
+				if (overlaps(shapeBoxes[order[i]], region)) {
+					shapes.push_back(order[i]);
+				}
+			}
+		} else {
+			stack[depth++] = node.left;
+			stack[depth++] = node.right;
+		}
+	}
+
+	std::sort(shapes.begin(), shapes.end());
+}
+
+int FrameBvh::nearest(float x, float y, float maxDistance) {
+	if (frame == nullptr) {
+		return -1;
+	}
+	if (!built) {
+		build();
+	}
+	if (nodes.empty()) {
+		return -1;
+	}
+
+	int best = -1;
+	float bestDistance = maxDistance == std::numeric_limits<float>::max() ? maxDistance : maxDistance * maxDistance;
+
+	int stack[64];
+	int depth = 0;
+	stack[depth++] = 0;
+	while (depth > 0) {
+		const Node& node = nodes[stack[--depth]];
+		if (squaredDistanceToBox(node.box, x, y) > bestDistance) {
+			continue;
+		}
+		if (node.isLeaf()) {
+			for (int i = node.first; i < node.first + node.count; i++) {
+				const uint32_t shape = order[i];
+				if (squaredDistanceToBox(shapeBoxes[shape], x, y) > bestDistance) {
+					continue;
+				}
+				const float distance = squaredDistanceToShape(*(*frame)[shape], x, y);
+				if (distance <= bestDistance) {
+					bestDistance = distance;
+					best = (int) shape;
+				}
+			}
+		} else {
+			// Visit the nearer child first so it tightens the bound for the other
+			const float leftDistance = squaredDistanceToBox(nodes[node.left].box, x, y);
+			const float rightDistance = squaredDistanceToBox(nodes[node.right].box, x, y);
+			if (leftDistance < rightDistance) {
+				stack[depth++] = node.right;
+				stack[depth++] = node.left;
+			} else {
+				stack[depth++] = node.left;
+				stack[depth++] = node.right;
+			}
+		}
+	}
+
+	return best;
+}
+
+} // namespace osci
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "osci_Frame.h"
+
+namespace osci {
+
+// Bounding volume hierarchy over the shapes of a frame, for culling to a view and
+// finding the shape nearest a point without visiting every shape. Queries are in
+// the x-y plane. The tree is built on the first query after the frame is set.
+//
+// The frame isn't owned and must outlive the tree. After changing shapes, call
+// refit() to update the boxes while keeping the tree, or scale() and translate()
+// with the same arguments when the whole frame was scaled or moved.
+class FrameBvh {
+public:
+	FrameBvh() = default;
+	explicit FrameBvh(const Frame& frame);
+
+	void setFrame(const Frame& frame);
+	// Forces a full rebuild on the next query, e.g. after shapes are added or removed.
+	void invalidate();
+
+	// Indices of shapes whose bounds overlap the region, in frame order.
+	void query(const BoundingBox& region, std::vector<size_t>& shapes);
+	// Index of the shape closest to (x, y), or -1 if none is within maxDistance.
+	int nearest(float x, float y, float maxDistance = std::numeric_limits<float>::max());
+
+	void refit();
+	void scale(float x, float y, float z);
+	void translate(float x, float y, float z);
+
+	static constexpr int MAX_LEAF_SHAPES = 4;
+
+private:
+	struct Node {
+		BoundingBox box;
+		// Children for inner nodes, or a range of order for leaves
+		int left = -1, right = -1;
+		int first = 0, count = 0;
+
+		bool isLeaf() const { return count > 0; }
+	};
+
+	void build();
+	int buildNode(int first, int count, const std::vector<float>& centreX, const std::vector<float>& centreY);
+	BoundingBox refitNode(int node);
+
+	const Frame* frame = nullptr;
+	bool built = false;
+	std::vector<Node> nodes;
+	// Shape indices, grouped so each leaf owns a contiguous range
+	std::vector<uint32_t> order;
+	std::vector<BoundingBox> shapeBoxes;
+};
+
+} // namespace osci
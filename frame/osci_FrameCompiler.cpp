@@ -0,0 +1,122 @@
+#include "osci_FrameCompiler.h"
+#include "osci_FrameIndex.h"
+
+namespace osci {
+
+void CompiledFrame::read(int start, int n, float* xs, float* ys, float* zs) const {
+	const int tableSize = size();
+	if (tableSize == 0) {
+		std::fill(xs, xs + n, 0.0f);
+		std::fill(ys, ys + n, 0.0f);
+		std::fill(zs, zs + n, 0.0f);
+		return;
+	}
+
+	start = ((start % tableSize) + tableSize) % tableSize;
+	while (n > 0) {
+		const int count = std::min(n, tableSize - start);
+		std::copy_n(x.data() + start, count, xs);
+		std::copy_n(y.data() + start, count, ys);
+		std::copy_n(z.data() + start, count, zs);
+		xs += count;
+		ys += count;
+		zs += count;
+		n -= count;
+		start = 0;
+	}
+}
+
+Point CompiledFrame::interpolate(double phase) const {
+	const int tableSize = size();
+	if (tableSize == 0) {
+		return Point();
+	}
+
+	const double position = (phase - std::floor(phase)) * tableSize;
+	const int index = std::min((int) position, tableSize - 1);
+	const int next = index + 1 == tableSize ? 0 : index + 1;
+	const float fraction = (float) (position - index);
+
+	return Point(
+		x[index] + (x[next] - x[index]) * fraction,
+		y[index] + (y[next] - y[index]) * fraction,
+		z[index] + (z[next] - z[index]) * fraction
+	);
+}
+
+FrameCompiler::FrameCompiler(size_t cacheSize) : cache(cacheSize) {}
+
+int FrameCompiler::tableSize(double sampleRate, double frequency) {
+	if (sampleRate <= 0 || frequency <= 0) {
+		return 0;
+	}
+	return std::max(1, (int) std::round(sampleRate / frequency));
+}
+
+std::shared_ptr<CompiledFrame> FrameCompiler::compileUncached(const Frame& frame, double sampleRate, double frequency) {
+	auto compiled = std::make_shared<CompiledFrame>();
+	const int numSamples = tableSize(sampleRate, frequency);
+	if (frame.empty() || numSamples == 0) {
+		return compiled;
+	}
+
+	compiled->x.resize(numSamples);
+	compiled->y.resize(numSamples);
+	compiled->z.resize(numSamples);
+
+	FrameIndex index(frame);
+	const double total = index.totalLength();
+
+	if (total <= 0) {
+		// Nothing to spread the samples over, so hold the start of the frame
+		Point start = frame[0]->nextVector(0);
+		std::fill(compiled->x.begin(), compiled->x.end(), start.x);
+		std::fill(compiled->y.begin(), compiled->y.end(), start.y);
+		std::fill(compiled->z.begin(), compiled->z.end(), start.z);
+		return compiled;
+	}
+
+	// Sample k is drawn at distance k * spacing along the frame. Each shape takes
+	// the samples whose distance falls within it, evenly spaced in its own progress.
+	const double spacing = total / numSamples;
+	int first = 0;
+	for (size_t i = 0; i < frame.size(); i++) {
+		const double shapeStart = index.startOf(i);
+		const double shapeLength = index.lengthOf(i);
+		const int end = i + 1 == frame.size() ? numSamples : std::min(numSamples, (int) std::ceil((shapeStart + shapeLength) / spacing));
+		const int count = end - first;
+
+		if (count > 0 && shapeLength > 0) {
+			const float start = (float) ((first * spacing - shapeStart) / shapeLength);
+			const float step = (float) (spacing / shapeLength);
+			frame[i]->sampleUniform(start, step, count, compiled->x.data() + first, compiled->y.data() + first, compiled->z.data() + first);
+		} else if (count > 0) {
+			// Only reachable through rounding on the last shape
+			Point point = frame[i]->nextVector(1);
+			std::fill_n(compiled->x.data() + first, count, point.x);
+			std::fill_n(compiled->y.data() + first, count, point.y);
+			std::fill_n(compiled->z.data() + first, count, point.z);
+		}
+		first = std::max(first, end);
+	}
+
+	return compiled;
+}
+
+std::shared_ptr<const CompiledFrame> FrameCompiler::compile(const Frame& frame, double sampleRate, double frequency) {
+	const Key key = { hashFrame(frame), tableSize(sampleRate, frequency) };
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (auto cached = cache.find(key)) {
+			return *cached;
+		}
+	}
+
+	std::shared_ptr<const CompiledFrame> compiled = compileUncached(frame, sampleRate, frequency);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	cache.insert(key, compiled);
+	return compiled;
+}
+
+} // namespace osci
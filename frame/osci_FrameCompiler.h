@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mutex>
+#include "osci_Frame.h"
+#include "osci_LruCache.h"
+#include "../shape/osci_Point.h"
+
+namespace osci {
+
+// One cycle of a frame evaluated at a fixed sample rate and frequency.
+struct CompiledFrame {
+	std::vector<float> x, y, z;
+
+	int size() const { return (int) x.size(); }
+
+	// Copies n samples starting at index start, wrapping around the end of the table.
+	void read(int start, int n, float* xs, float* ys, float* zs) const;
+	// Sample at phase in [0, 1), linearly interpolated between table entries.
+	Point interpolate(double phase) const;
+};
+
+// Turns frames into tables of samples so static or looping content can be played
+// back without evaluating every shape on every cycle. Samples are spread over
+// the frame by drawing distance, as when the frame is drawn shape by shape.
+class FrameCompiler {
+public:
+	explicit FrameCompiler(size_t cacheSize = 16);
+
+	// Returns the cached table for this frame, rate and frequency, compiling it if
+	// needed. Tables are cached by their size, so frequencies that round to the
+	// same number of samples per cycle share one.
+	std::shared_ptr<const CompiledFrame> compile(const Frame& frame, double sampleRate, double frequency);
+
+	static std::shared_ptr<CompiledFrame> compileUncached(const Frame& frame, double sampleRate, double frequency);
+
+private:
+	// Samples in one cycle, or 0 when there's no cycle to compile
+	static int tableSize(double sampleRate, double frequency);
+
+	struct Key {
+		uint64_t hash;
+		int tableSize;
+
+		bool operator==(const Key& other) const {
+			return hash == other.hash && tableSize == other.tableSize;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			size_t hash = std::hash<uint64_t>()(key.hash);
+			hash ^= std::hash<int>()(key.tableSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+
+	std::mutex mutex;
+	LruCache<Key, std::shared_ptr<const CompiledFrame>, KeyHash> cache;
+};
+
+} // namespace osci
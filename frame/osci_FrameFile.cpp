@@ -0,0 +1,273 @@
+#include "osci_FrameFile.h"
+#include "../osci_Util.h"
+
+namespace osci {
+
+static constexpr char FRAME_FILE_MAGIC[4] = { 'O', 'S', 'C', 'F' };
+static constexpr size_t FRAME_FILE_HEADER_SIZE = 16;
+static constexpr int NUM_COORDINATE_ARRAYS = ShapeBuffer::NUM_COORDINATE_ARRAYS;
+
+static size_t alignTo(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static size_t arrayBytes(size_t count, int array, bool quantised) {
+	const size_t elementSize = quantised && ShapeBuffer::isQuantisable(array) ? sizeof(int16_t) : sizeof(float);
+	return alignTo(count * elementSize, 4);
+}
+
+// Number of elements in each coordinate array, in ShapeBuffer order.
+static size_t arrayCount(int array, uint64_t numLines, uint64_t numCurves, uint64_t numArcs) {
+	if (array < ShapeBuffer::FIRST_CURVE_ARRAY) {
+		return numLines;
+	}
+	if (array < ShapeBuffer::FIRST_ARC_ARRAY) {
+		return numCurves;
+	}
+	return numArcs;
+}
+
+static void arraysOf(const ShapeBufferView& view, const float* arrays[NUM_COORDINATE_ARRAYS]) {
+	const float* all[NUM_COORDINATE_ARRAYS] = {
+		view.lines.x1, view.lines.y1, view.lines.z1, view.lines.x2, view.lines.y2, view.lines.z2,
+		view.curves.x1, view.curves.y1, view.curves.x2, view.curves.y2, view.curves.x3, view.curves.y3, view.curves.x4, view.curves.y4,
+		view.arcs.x, view.arcs.y, view.arcs.radiusX, view.arcs.radiusY, view.arcs.startAngle, view.arcs.endAngle,
+	};
+	std::copy(all, all + NUM_COORDINATE_ARRAYS, arrays);
+}
+
+static uint64_t frameBytes(uint64_t numShapes, uint64_t numLines, uint64_t numCurves, uint64_t numArcs, bool quantised) {
+	uint64_t bytes = 32 + alignTo(numShapes, 4) + numShapes * sizeof(uint32_t);
+	for (int array = 0; array < NUM_COORDINATE_ARRAYS; array++) {
+		bytes += arrayBytes(arrayCount(array, numLines, numCurves, numArcs), array, quantised);
+	}
+	return bytes;
+}
+
+static bool writeBytes(juce::OutputStream& stream, const void* bytes, size_t size) {
+	return size == 0 || stream.write(bytes, size);
+}
+
+static bool writePadding(juce::OutputStream& stream, size_t size) {
+	return size == 0 || stream.writeRepeatedByte(0, size);
+}
+
+bool FrameFile::write(juce::OutputStream& stream, const std::vector<ShapeBuffer>& frames, bool quantised) {
+	static_assert(sizeof(FrameHeader) == 32);
+
+	if (juce::ByteOrder::isBigEndian()) {
+		jassertfalse;
+		return false;
+	}
+
+	const uint32_t header[3] = { VERSION, quantised ? QUANTISED : 0, (uint32_t) frames.size() };
+	bool ok = writeBytes(stream, FRAME_FILE_MAGIC, 4) && writeBytes(stream, header, sizeof(header));
+
+	const uint64_t tableEnd = FRAME_FILE_HEADER_SIZE + frames.size() * sizeof(uint64_t);
+	std::vector<uint64_t> offsets(frames.size());
+	uint64_t offset = alignTo(tableEnd, 16);
+	for (size_t i = 0; i < frames.size(); i++) {
+		const ShapeBufferView view = frames[i].view();
+		offsets[i] = offset;
+		offset = alignTo(offset + frameBytes(view.numShapes, view.numLines, view.numCurves, view.numArcs, quantised), 16);
+	}
+	ok = ok && writeBytes(stream, offsets.data(), offsets.size() * sizeof(uint64_t));
+	ok = ok && writePadding(stream, (size_t) (alignTo(tableEnd, 16) - tableEnd));
+
+	std::vector<int16_t> quantisedArray;
+	for (size_t i = 0; i < frames.size() && ok; i++) {
+		const ShapeBufferView view = frames[i].view();
+		const float* arrays[NUM_COORDINATE_ARRAYS];
+		arraysOf(view, arrays);
+
+		float range = 0;
+		if (quantised) {
+			for (int array = 0; array < ShapeBuffer::NUM_QUANTISABLE_ARRAYS; array++) {
+				const size_t count = arrayCount(array, view.numLines, view.numCurves, view.numArcs);
+				for (size_t k = 0; k < count; k++) {
+					range = std::max(range, std::abs(arrays[array][k]));
+				}
+			}
+			if (range <= 0) {
+				range = 1;
+			}
+		}
+
+		const FrameHeader frameHeader = { (uint32_t) view.numShapes, (uint32_t) view.numLines, (uint32_t) view.numCurves, (uint32_t) view.numArcs, range, { 0, 0, 0 } };
+		ok = ok && writeBytes(stream, &frameHeader, sizeof(frameHeader));
+		ok = ok && writeBytes(stream, view.tags, view.numShapes);
+		ok = ok && writePadding(stream, alignTo(view.numShapes, 4) - view.numShapes);
+		ok = ok && writeBytes(stream, view.indices, view.numShapes * sizeof(uint32_t));
+
+		for (int array = 0; array < NUM_COORDINATE_ARRAYS; array++) {
+			const size_t count = arrayCount(array, view.numLines, view.numCurves, view.numArcs);
+			const size_t bytes = arrayBytes(count, array, quantised);
+			size_t written;
+			if (quantised && ShapeBuffer::isQuantisable(array)) {
+				quantisedArray.resize(count);
+				Util::quantise(arrays[array], quantisedArray.data(), count, range);
+				written = count * sizeof(int16_t);
+				ok = ok && writeBytes(stream, quantisedArray.data(), written);
+			} else {
+				written = count * sizeof(float);
+				ok = ok && writeBytes(stream, arrays[array], written);
+			}
+			ok = ok && writePadding(stream, bytes - written);
+		}
+
+		const uint64_t end = offsets[i] + frameBytes(view.numShapes, view.numLines, view.numCurves, view.numArcs, quantised);
+		ok = ok && writePadding(stream, (size_t) (alignTo(end, 16) - end));
+	}
+
+	return ok;
+}
+
+FrameFile::FrameFile(const juce::File& file) {
+	mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+	if (mappedFile->getData() != nullptr) {
+		valid = open(mappedFile->getData(), mappedFile->getSize());
+	}
+}
+
+FrameFile::FrameFile(const void* data, size_t size) {
+	valid = open(data, size);
+}
+
+bool FrameFile::open(const void* fileData, size_t fileSize) {
+	data = static_cast<const uint8_t*>(fileData);
+	size = fileSize;
+
+	if (juce::ByteOrder::isBigEndian() || reinterpret_cast<uintptr_t>(data) % 4 != 0) {
+		return false;
+	}
+	if (size < FRAME_FILE_HEADER_SIZE || std::memcmp(data, FRAME_FILE_MAGIC, 4) != 0) {
+		return false;
+	}
+
+	uint32_t header[4];
+	std::memcpy(header, data, sizeof(header));
+	if (header[1] != VERSION || (header[2] & ~QUANTISED) != 0) {
+		return false;
+	}
+	flags = header[2];
+	numFrames = header[3];
+
+	// Frame contents are checked when they're accessed, so opening stays O(1) in the number of shapes
+	return (uint64_t) numFrames * sizeof(uint64_t) <= size - FRAME_FILE_HEADER_SIZE;
+}
+
+bool FrameFile::isQuantised() const {
+	return (flags & QUANTISED) != 0;
+}
+
+bool FrameFile::layout(int frame, FrameLayout& layout) const {
+	if (!valid || frame < 0 || (uint32_t) frame >= numFrames) {
+		return false;
+	}
+
+	uint64_t offset;
+	std::memcpy(&offset, data + FRAME_FILE_HEADER_SIZE + frame * sizeof(uint64_t), sizeof(offset));
+	if (offset % 4 != 0 || offset > size || size - offset < sizeof(FrameHeader)) {
+		return false;
+	}
+
+	FrameHeader& header = layout.header;
+	std::memcpy(&header, data + offset, sizeof(header));
+	const bool quantised = isQuantised();
+	if (frameBytes(header.numShapes, header.numLines, header.numCurves, header.numArcs, quantised) > size - offset) {
+		return false;
+	}
+
+	const uint8_t* position = data + offset + sizeof(FrameHeader);
+	layout.tags = reinterpret_cast<const ShapeBuffer::Tag*>(position);
+	position += alignTo(header.numShapes, 4);
+	layout.indices = reinterpret_cast<const uint32_t*>(position);
+	position += header.numShapes * sizeof(uint32_t);
+
+	for (int array = 0; array < NUM_COORDINATE_ARRAYS; array++) {
+		layout.arrays[array] = position;
+		position += arrayBytes(arrayCount(array, header.numLines, header.numCurves, header.numArcs), array, quantised);
+	}
+
+	// Every shape must refer to an element of its kind's arrays
+	for (uint32_t i = 0; i < header.numShapes; i++) {
+		uint32_t count;
+		switch (layout.tags[i]) {
+			case ShapeBuffer::Tag::Line:
+				count = header.numLines;
+				break;
+			case ShapeBuffer::Tag::CubicBezierCurve:
+				count = header.numCurves;
+				break;
+			case ShapeBuffer::Tag::CircleArc:
+				count = header.numArcs;
+				break;
+			default:
+				return false;
+		}
+		if (layout.indices[i] >= count) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ShapeBufferView FrameFile::viewOf(const FrameLayout& frameLayout) {
+	auto array = [&frameLayout](int index) {
+		return reinterpret_cast<const float*>(frameLayout.arrays[index]);
+	};
+
+	ShapeBufferView view;
+	view.tags = frameLayout.tags;
+	view.indices = frameLayout.indices;
+	view.numShapes = frameLayout.header.numShapes;
+	view.numLines = frameLayout.header.numLines;
+	view.numCurves = frameLayout.header.numCurves;
+	view.numArcs = frameLayout.header.numArcs;
+	view.lines = { array(0), array(1), array(2), array(3), array(4), array(5) };
+	view.curves = { array(6), array(7), array(8), array(9), array(10), array(11), array(12), array(13) };
+	view.arcs = { array(14), array(15), array(16), array(17), array(18), array(19) };
+	return view;
+}
+
+ShapeBufferView FrameFile::view(int frame) const {
+	FrameLayout frameLayout;
+	if (isQuantised() || !layout(frame, frameLayout)) {
+		return {};
+	}
+	return viewOf(frameLayout);
+}
+
+bool FrameFile::read(int frame, ShapeBuffer& buffer) const {
+	FrameLayout frameLayout;
+	if (!layout(frame, frameLayout)) {
+		buffer.clear();
+		return false;
+	}
+
+	if (!isQuantised()) {
+		buffer.assign(viewOf(frameLayout));
+		return true;
+	}
+
+	const FrameHeader& header = frameLayout.header;
+	buffer.tags.assign(frameLayout.tags, frameLayout.tags + header.numShapes);
+	buffer.indices.assign(frameLayout.indices, frameLayout.indices + header.numShapes);
+	buffer.lengths.assign(header.numShapes, Shape::INVALID_LENGTH);
+
+	auto arrays = buffer.coordinateArrays();
+	for (int array = 0; array < NUM_COORDINATE_ARRAYS; array++) {
+		const size_t count = arrayCount(array, header.numLines, header.numCurves, header.numArcs);
+		arrays[array]->resize(count);
+		if (ShapeBuffer::isQuantisable(array)) {
+			Util::dequantise(reinterpret_cast<const int16_t*>(frameLayout.arrays[array]), arrays[array]->data(), count, header.range);
+		} else if (count > 0) {
+			std::memcpy(arrays[array]->data(), frameLayout.arrays[array], count * sizeof(float));
+		}
+	}
+
+	return true;
+}
+
+} // namespace osci
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "osci_ShapeBuffer.h"
+
+namespace osci {
+
+// Versioned binary store for a sequence of frames, laid out so a memory-mapped
+// file can be viewed as ShapeBuffer arrays directly. Opening a file only checks
+// its header and frame table, so it costs the same however many shapes it holds.
+//
+// Layout, all little-endian:
+//   header       "OSCF", version, flags, frame count (4 x 4 bytes)
+//   frame table  byte offset of each frame (8 bytes each)
+//   frames       each 16-byte aligned: shape, line, curve and arc counts and the
+//                quantisation range, then tags, kind indices and each coordinate
+//                array in ShapeBuffer order, padded to 4 bytes.
+class FrameFile {
+public:
+	static constexpr uint32_t VERSION = 1;
+
+	// Writes frames to the stream. When quantised, coordinates are stored as
+	// 16-bit integers scaled to each frame's extent, halving their size. Arc
+	// angles are always stored as floats, see ShapeBuffer::isQuantisable.
+	static bool write(juce::OutputStream& stream, const std::vector<ShapeBuffer>& frames, bool quantised = false);
+
+	// Maps the file into memory. Nothing is read until frames are accessed.
+	explicit FrameFile(const juce::File& file);
+	// Reads from 4-byte aligned memory owned by the caller, which must outlive this object.
+	FrameFile(const void* data, size_t size);
+
+	bool isValid() const { return valid; }
+	bool isQuantised() const;
+	int getNumFrames() const { return (int) numFrames; }
+
+	// Views a frame in place, without copying. Quantised files can't be viewed,
+	// and give an empty view, as does a frame that fails validation.
+	ShapeBufferView view(int frame) const;
+	// Copies or decodes a frame into the buffer, reusing its storage. Returns
+	// false, leaving the buffer empty, if the frame fails validation.
+	bool read(int frame, ShapeBuffer& buffer) const;
+
+private:
+	struct FrameHeader {
+		uint32_t numShapes;
+		uint32_t numLines;
+		uint32_t numCurves;
+		uint32_t numArcs;
+		float range;
+		uint32_t reserved[3];
+	};
+
+	struct FrameLayout {
+		FrameHeader header;
+		const ShapeBuffer::Tag* tags;
+		const uint32_t* indices;
+		// Start of each coordinate array, in ShapeBuffer order
+		const uint8_t* arrays[ShapeBuffer::NUM_COORDINATE_ARRAYS];
+	};
+
+	static constexpr uint32_t QUANTISED = 1;
+
+	bool open(const void* data, size_t size);
+	bool layout(int frame, FrameLayout& layout) const;
+	static ShapeBufferView viewOf(const FrameLayout& layout);
+
+	std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	bool valid = false;
+	uint32_t flags = 0;
+	uint32_t numFrames = 0;
+};
+
+} // namespace osci
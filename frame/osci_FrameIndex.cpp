@@ -0,0 +1,96 @@
+#include "osci_FrameIndex.h"
+
+namespace osci {
+
+FrameIndex::FrameIndex(const Frame& frame) {
+	rebuild(frame);
+}
+
+void FrameIndex::rebuild(const Frame& frame) {
+	prefix.resize(frame.size() + 1);
+	prefix[0] = 0;
+	for (size_t i = 0; i < frame.size(); i++) {
+		prefix[i + 1] = prefix[i] + frame[i]->length();
+	}
+}
+
+FrameIndex::Location FrameIndex::locationIn(size_t shape, double distance) const {
+	const double length = lengthOf(shape);
+	if (length <= 0) {
+		return { shape, 0.0f };
+	}
+	return { shape, (float) std::clamp((distance - prefix[shape]) / length, 0.0, 1.0) };
+}
+
+FrameIndex::Location FrameIndex::locateDistance(double distance) const {
+	const size_t n = size();
+	if (n == 0) {
+		return { 0, 0.0f };
+	}
+	if (totalLength() <= 0) {
+		return { 0, 0.0f };
+	}
+
+	// First shape that ends after the distance
+	auto it = std::upper_bound(prefix.begin() + 1, prefix.end(), distance);
+	if (it == prefix.end()) {
+		// At or past the end, so finish on the last shape with any length
+		size_t shape = n - 1;
+		while (shape > 0 && lengthOf(shape) <= 0) {
+			shape--;
+		}
+		return { shape, 1.0f };
+	}
+
+	const size_t shape = (size_t) (it - prefix.begin()) - 1;
+	return locationIn(shape, distance);
+}
+
+FrameIndex::Location FrameIndex::locate(double progress) const {
+	return locateDistance(progress * totalLength());
+}
+
+FrameIndex::Cursor::Cursor(const FrameIndex& index, double progress) : index(index) {
+	reset(progress);
+}
+
+void FrameIndex::Cursor::reset(double progress) {
+	const double total = index.totalLength();
+	distance = total > 0 ? (progress - std::floor(progress)) * total : 0;
+	shape = index.size() == 0 ? 0 : index.locateDistance(distance).shape;
+}
+
+FrameIndex::Location FrameIndex::Cursor::advance(double delta) {
+	const double total = index.totalLength();
+	const size_t n = index.size();
+	if (total <= 0 || n == 0) {
+		return { 0, 0.0f };
+	}
+
+	distance += delta * total;
+	if (distance >= total || distance < 0) {
+		distance -= std::floor(distance / total) * total;
+		shape = 0;
+	} else if (distance < index.prefix[shape]) {
+		shape = index.locateDistance(distance).shape;
+	}
+
+	while (shape + 1 < n && index.prefix[shape + 1] <= distance) {
+		shape++;
+	}
+	return index.locationIn(shape, distance);
+}
+
+FrameIndex::Location FrameIndex::Cursor::location() const {
+	if (index.size() == 0) {
+		return { 0, 0.0f };
+	}
+	return index.locationIn(shape, distance);
+}
+
+double FrameIndex::Cursor::progress() const {
+	const double total = index.totalLength();
+	return total > 0 ? distance / total : 0;
+}
+
+} // namespace osci
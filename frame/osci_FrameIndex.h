@@ -0,0 +1,58 @@
+#pragma once
+
+#include "osci_Frame.h"
+
+namespace osci {
+
+// Cumulative shape lengths for a frame, so a position along the whole frame can
+// be mapped to a shape and a progress within it without walking every shape.
+// The index doesn't own the frame and must be rebuilt if its shapes change.
+class FrameIndex {
+public:
+	struct Location {
+		size_t shape;
+		float t;
+	};
+
+	FrameIndex() = default;
+	explicit FrameIndex(const Frame& frame);
+
+	void rebuild(const Frame& frame);
+
+	size_t size() const { return prefix.empty() ? 0 : prefix.size() - 1; }
+	double totalLength() const { return prefix.empty() ? 0 : prefix.back(); }
+	double startOf(size_t shape) const { return prefix[shape]; }
+	double lengthOf(size_t shape) const { return prefix[shape + 1] - prefix[shape]; }
+
+	// Shape and local progress at the given fraction of the frame's total length,
+	// found by binary search. Zero-length shapes are never returned unless every
+	// shape has zero length.
+	Location locate(double progress) const;
+	Location locateDistance(double distance) const;
+
+	// Walks forward through the frame, so advancing by less than a shape at a
+	// time costs O(1). Each consumer sampling the frame keeps its own cursor.
+	class Cursor {
+	public:
+		explicit Cursor(const FrameIndex& index, double progress = 0);
+
+		void reset(double progress);
+		// Moves forward by delta progress, wrapping at the end of the frame.
+		Location advance(double delta);
+		Location location() const;
+		double progress() const;
+
+	private:
+		const FrameIndex& index;
+		size_t shape = 0;
+		double distance = 0;
+	};
+
+private:
+	Location locationIn(size_t shape, double distance) const;
+
+	// prefix[i] is the length of shapes 0 to i - 1
+	std::vector<double> prefix;
+};
+
+} // namespace osci
@@ -0,0 +1,179 @@
+#include "osci_FrameLod.h"
+#include "../shape/osci_Line.h"
+#include "../shape/osci_CubicBezierCurve.h"
+
+namespace osci {
+
+// Endpoints closer than this are treated as joined when building polylines.
+static constexpr float CONNECT_TOLERANCE = 1e-6f;
+
+struct LodVertex {
+	float x, y, z;
+};
+
+static float squaredDistanceToSegment(const LodVertex& p, const LodVertex& a, const LodVertex& b) {
+	const float abx = b.x - a.x, aby = b.y - a.y, abz = b.z - a.z;
+	const float apx = p.x - a.x, apy = p.y - a.y, apz = p.z - a.z;
+	const float lengthSquared = abx * abx + aby * aby + abz * abz;
+
+	float t = 0.0f;
+	if (lengthSquared > 0.0f) {
+		t = std::clamp((apx * abx + apy * aby + apz * abz) / lengthSquared, 0.0f, 1.0f);
+	}
+
+	const float dx = apx - t * abx, dy = apy - t * aby, dz = apz - t * abz;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+static bool connected(const LodVertex& a, const LodVertex& b) {
+	const float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+	return dx * dx + dy * dy + dz * dz <= CONNECT_TOLERANCE * CONNECT_TOLERANCE;
+}
+
+// Returns true if the shape can be drawn as the straight segment start -> end.
+static bool asSegment(Shape& shape, float tolerance, LodVertex& start, LodVertex& end) {
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		start = { line->x1, line->y1, line->z1 };
+		end = { line->x2, line->y2, line->z2 };
+		return true;
+	}
+	if (auto curve = dynamic_cast<CubicBezierCurve*>(&shape)) {
+		// By the convex hull property the curve is no further from its chord
+		// than its furthest control point.
+		start = { curve->x1, curve->y1, 0 };
+		end = { curve->x4, curve->y4, 0 };
+		const float limit = tolerance * tolerance;
+		return squaredDistanceToSegment({ curve->x2, curve->y2, 0 }, start, end) <= limit
+			&& squaredDistanceToSegment({ curve->x3, curve->y3, 0 }, start, end) <= limit;
+	}
+	return false;
+}
+
+// Ramer-Douglas-Peucker on a polyline, with an explicit stack so long chains
+// from dense meshes can't overflow the call stack.
+static void reducePolyline(const std::vector<LodVertex>& chain, float tolerance, std::vector<uint8_t>& keep, std::vector<std::pair<size_t, size_t>>& stack) {
+	keep.assign(chain.size(), 0);
+	keep.front() = 1;
+	keep.back() = 1;
+
+	const float limit = tolerance * tolerance;
+	stack.clear();
+	stack.emplace_back(0, chain.size() - 1);
+
+	while (!stack.empty()) {
+		auto [first, last] = stack.back();
+		stack.pop_back();
+
+		float furthestDistance = limit;
+		size_t furthest = first;
+		for (size_t i = first + 1; i < last; i++) {
+			const float distance = squaredDistanceToSegment(chain[i], chain[first], chain[last]);
+			if (distance > furthestDistance) {
+				furthestDistance = distance;
+				furthest = i;
+			}
+		}
+
+		if (furthest != first) {
+			keep[furthest] = 1;
+			stack.emplace_back(first, furthest);
+			stack.emplace_back(furthest, last);
+		}
+	}
+}
+
+Frame FrameLod::simplify(const Frame& frame, float tolerance) {
+	Frame result;
+	result.reserve(frame.size());
+
+	std::vector<LodVertex> chain;
+	std::vector<uint8_t> keep;
+	std::vector<std::pair<size_t, size_t>> stack;
+
+	auto flushChain = [&]() {
+		if (chain.size() >= 2) {
+			reducePolyline(chain, tolerance, keep, stack);
+			size_t previous = 0;
+			for (size_t i = 1; i < chain.size(); i++) {
+				if (keep[i]) {
+					const LodVertex& a = chain[previous];
+					const LodVertex& b = chain[i];
+					result.push_back(std::make_unique<Line>(a.x, a.y, a.z, b.x, b.y, b.z));
+					previous = i;
+				}
+			}
+		}
+		chain.clear();
+	};
+
+	for (auto& shape : frame) {
+		LodVertex start, end;
+		if (asSegment(*shape, tolerance, start, end)) {
+			if (chain.empty() || !connected(chain.back(), start)) {
+				flushChain();
+				chain.push_back(start);
+			}
+			chain.push_back(end);
+		} else {
+			flushChain();
+			result.push_back(shape->clone());
+		}
+	}
+	flushChain();
+
+	return result;
+}
+
+FrameLod::FrameLod(Frame&& frame, float baseTolerance, int maxLevels) : maxLevels(maxLevels), nextTolerance(baseTolerance) {
+	// Reserved up front so that references returned by level() stay valid as more levels are built
+	levels.reserve(std::max(1, maxLevels));
+	const BoundingBox box = Shape::boundingBox(frame);
+	if (!box.isEmpty()) {
+		maxTolerance = std::max({ box.maxX - box.minX, box.maxY - box.minY, box.maxZ - box.minZ });
+	}
+	levels.push_back(std::move(frame));
+}
+
+bool FrameLod::buildNextLevel() {
+	// A tolerance that removes nothing is doubled until one does, since dense
+	// geometry can sit just above the finer tolerances. Beyond the frame's extent
+	// everything simplifiable already has been.
+	while (!complete && (int) levels.size() < maxLevels && nextTolerance <= maxTolerance) {
+		Frame next = simplify(levels.back(), nextTolerance);
+		nextTolerance *= 2;
+		if (next.size() < levels.back().size()) {
+			levels.push_back(std::move(next));
+			return true;
+		}
+	}
+
+	complete = true;
+	return false;
+}
+
+void FrameLod::build() {
+	while (buildNextLevel()) {}
+}
+
+const Frame& FrameLod::level(int index) {
+	while (index >= (int) levels.size() && buildNextLevel()) {}
+	return levels[std::min(index, (int) levels.size() - 1)];
+}
+
+int FrameLod::levelFor(float sampleBudget, float samplesPerShape) {
+	const float maxShapes = sampleBudget / samplesPerShape;
+	for (int index = 0;; index++) {
+		if ((float) level(index).size() <= maxShapes) {
+			return index;
+		}
+		if (index + 1 >= (int) levels.size() && !buildNextLevel()) {
+			return index;
+		}
+	}
+}
+
+const Frame& FrameLod::frameFor(float sampleBudget, float samplesPerShape) {
+	return level(levelFor(sampleBudget, samplesPerShape));
+}
+
+} // namespace osci
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "osci_Frame.h"
+
+namespace osci {
+
+// Pyramid of progressively simplified versions of a frame. Level 0 is the frame
+// itself and each level above it simplifies the one below with at least double
+// the previous tolerance, so a renderer that can only afford a limited number of
+// samples per frame can draw a coarser level instead of flickering through the
+// full one.
+//
+// Levels are built on first use. Call build() from the producer thread so that
+// level() and levelFor() never allocate when called from the audio thread.
+class FrameLod {
+public:
+	explicit FrameLod(Frame&& frame, float baseTolerance = 1.0f / 1024.0f, int maxLevels = 8);
+
+	void build();
+
+	// The returned reference stays valid for the lifetime of this object.
+	const Frame& level(int index);
+	// Number of levels built so far, or the final count once build() has run.
+	int numLevels() const { return (int) levels.size(); }
+
+	// Finest level that can be drawn with at least samplesPerShape samples for
+	// each shape, or the coarsest level when none fit.
+	int levelFor(float sampleBudget, float samplesPerShape = 2.0f);
+	const Frame& frameFor(float sampleBudget, float samplesPerShape = 2.0f);
+
+	// Joins connected lines and flat Bézier curves into polylines and reduces
+	// each with Ramer-Douglas-Peucker. Curves are only flattened when their
+	// control points are within tolerance of the chord. Other shapes are copied.
+	static Frame simplify(const Frame& frame, float tolerance);
+
+private:
+	bool buildNextLevel();
+
+	std::vector<Frame> levels;
+	int maxLevels;
+	// Tolerance the next level is simplified with, and the frame's largest
+	// extent, past which there's nothing left to simplify.
+	float nextTolerance;
+	float maxTolerance = 0;
+	// Set once another level would either exceed maxLevels or need a tolerance
+	// beyond the frame's extent to remove any shapes.
+	bool complete = false;
+};
+
+} // namespace osci
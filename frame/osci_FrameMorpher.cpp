@@ -0,0 +1,169 @@
+#include "osci_FrameMorpher.h"
+#include <numeric>
+#include "../shape/osci_Line.h"
+
+namespace osci {
+
+FrameMorpher::FrameMorpher(int segmentsPerShape) : segmentsPerShape(std::max(1, segmentsPerShape)) {}
+
+void FrameMorpher::sample(const Frame& frame, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, std::vector<ShapeSamples>& shapes) const {
+	const int pointsPerShape = segmentsPerShape + 1;
+	x.resize(frame.size() * pointsPerShape);
+	y.resize(frame.size() * pointsPerShape);
+	z.resize(frame.size() * pointsPerShape);
+	shapes.resize(frame.size());
+
+	for (size_t i = 0; i < frame.size(); i++) {
+		const size_t first = i * pointsPerShape;
+		frame[i]->sampleUniform(0.0f, 1.0f / segmentsPerShape, pointsPerShape, x.data() + first, y.data() + first, z.data() + first);
+
+		ShapeSamples& shape = shapes[i];
+		shape.centreX = shape.centreY = shape.centreZ = 0;
+		for (int k = 0; k < pointsPerShape; k++) {
+			shape.centreX += x[first + k];
+			shape.centreY += y[first + k];
+			shape.centreZ += z[first + k];
+		}
+		shape.centreX /= pointsPerShape;
+		shape.centreY /= pointsPerShape;
+		shape.centreZ /= pointsPerShape;
+		shape.length = frame[i]->length();
+	}
+}
+
+void FrameMorpher::prepare(const Frame& from, const Frame& to) {
+	const int pointsPerShape = segmentsPerShape + 1;
+
+	std::vector<float> ax, ay, az, bx, by, bz;
+	std::vector<ShapeSamples> a, b;
+	sample(from, ax, ay, az, a);
+	sample(to, bx, by, bz, b);
+
+	// Greedy matching, longest shapes first since mismatching them is most visible
+	std::vector<size_t> order(a.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&a](size_t i, size_t j) { return a[i].length > a[j].length; });
+
+	std::vector<int> partner(a.size(), -1);
+	std::vector<bool> used(b.size(), false);
+	for (size_t i : order) {
+		float bestCost = std::numeric_limits<float>::max();
+		int best = -1;
+		for (size_t j = 0; j < b.size(); j++) {
+			if (used[j]) {
+				continue;
+			}
+			const float dx = a[i].centreX - b[j].centreX;
+			const float dy = a[i].centreY - b[j].centreY;
+			const float dz = a[i].centreZ - b[j].centreZ;
+			const float cost = std::sqrt(dx * dx + dy * dy + dz * dz) + std::abs(a[i].length - b[j].length);
+			if (cost < bestCost) {
+				bestCost = cost;
+				best = (int) j;
+			}
+		}
+		if (best >= 0) {
+			partner[i] = best;
+			used[best] = true;
+		}
+	}
+
+	const size_t numPairs = a.size() + std::count(used.begin(), used.end(), false);
+	for (auto array : { &fromX, &fromY, &fromZ, &toX, &toY, &toZ }) {
+		array->resize(numPairs * pointsPerShape);
+	}
+
+	auto copyPoints = [pointsPerShape](const std::vector<float>& sx, const std::vector<float>& sy, const std::vector<float>& sz, size_t shape, bool reversed,
+									   std::vector<float>& dx, std::vector<float>& dy, std::vector<float>& dz, size_t pair) {
+		for (int k = 0; k < pointsPerShape; k++) {
+			const size_t source = shape * pointsPerShape + (reversed ? pointsPerShape - 1 - k : k);
+			const size_t destination = pair * pointsPerShape + k;
+			dx[destination] = sx[source];
+			dy[destination] = sy[source];
+			dz[destination] = sz[source];
+		}
+	};
+	auto fillPoint = [pointsPerShape](const ShapeSamples& shape, std::vector<float>& dx, std::vector<float>& dy, std::vector<float>& dz, size_t pair) {
+		std::fill_n(dx.begin() + pair * pointsPerShape, pointsPerShape, shape.centreX);
+		std::fill_n(dy.begin() + pair * pointsPerShape, pointsPerShape, shape.centreY);
+		std::fill_n(dz.begin() + pair * pointsPerShape, pointsPerShape, shape.centreZ);
+	};
+	auto squaredDistance = [](float x1, float y1, float z1, float x2, float y2, float z2) {
+		return (x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1) + (z2 - z1) * (z2 - z1);
+	};
+
+	size_t pair = 0;
+	for (size_t i = 0; i < a.size(); i++, pair++) {
+		copyPoints(ax, ay, az, i, false, fromX, fromY, fromZ, pair);
+		if (partner[i] < 0) {
+			fillPoint(a[i], toX, toY, toZ, pair);
+			continue;
+		}
+
+		// Run the partner backwards if that keeps the ends closer together
+		const size_t j = (size_t) partner[i];
+		const size_t aStart = i * pointsPerShape, aEnd = aStart + pointsPerShape - 1;
+		const size_t bStart = j * pointsPerShape, bEnd = bStart + pointsPerShape - 1;
+		const float forward = squaredDistance(ax[aStart], ay[aStart], az[aStart], bx[bStart], by[bStart], bz[bStart])
+			+ squaredDistance(ax[aEnd], ay[aEnd], az[aEnd], bx[bEnd], by[bEnd], bz[bEnd]);
+		const float backward = squaredDistance(ax[aStart], ay[aStart], az[aStart], bx[bEnd], by[bEnd], bz[bEnd])
+			+ squaredDistance(ax[aEnd], ay[aEnd], az[aEnd], bx[bStart], by[bStart], bz[bStart]);
+		copyPoints(bx, by, bz, j, backward < forward, toX, toY, toZ, pair);
+	}
+	for (size_t j = 0; j < b.size(); j++) {
+		if (!used[j]) {
+			fillPoint(b[j], fromX, fromY, fromZ, pair);
+			copyPoints(bx, by, bz, j, false, toX, toY, toZ, pair);
+			pair++;
+		}
+	}
+
+	const size_t numLines = numPairs * segmentsPerShape;
+	output.clear();
+	lines.clear();
+	output.reserve(numLines);
+	lines.reserve(numLines);
+	for (size_t i = 0; i < numLines; i++) {
+		auto line = std::make_unique<Line>(0, 0, 0, 0, 0, 0);
+		lines.push_back(line.get());
+		output.push_back(std::move(line));
+	}
+}
+
+void FrameMorpher::morph(float amount, float* x, float* y, float* z) const {
+	const size_t n = fromX.size();
+	for (size_t i = 0; i < n; i++) {
+		x[i] = fromX[i] + (toX[i] - fromX[i]) * amount;
+		y[i] = fromY[i] + (toY[i] - fromY[i]) * amount;
+		z[i] = fromZ[i] + (toZ[i] - fromZ[i]) * amount;
+	}
+}
+
+const Frame& FrameMorpher::morph(float amount) {
+	const int pointsPerShape = segmentsPerShape + 1;
+	const size_t numPairs = fromX.size() / pointsPerShape;
+
+	size_t line = 0;
+	for (size_t pair = 0; pair < numPairs; pair++) {
+		const size_t first = pair * pointsPerShape;
+		float previousX = fromX[first] + (toX[first] - fromX[first]) * amount;
+		float previousY = fromY[first] + (toY[first] - fromY[first]) * amount;
+		float previousZ = fromZ[first] + (toZ[first] - fromZ[first]) * amount;
+
+		for (int k = 1; k < pointsPerShape; k++, line++) {
+			const size_t i = first + k;
+			Line& segment = *lines[line];
+			segment.x1 = previousX;
+			segment.y1 = previousY;
+			segment.z1 = previousZ;
+			segment.x2 = previousX = fromX[i] + (toX[i] - fromX[i]) * amount;
+			segment.y2 = previousY = fromY[i] + (toY[i] - fromY[i]) * amount;
+			segment.z2 = previousZ = fromZ[i] + (toZ[i] - fromZ[i]) * amount;
+			segment.len = Shape::INVALID_LENGTH;
+		}
+	}
+
+	return output;
+}
+
+} // namespace osci
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "osci_Frame.h"
+
+namespace osci {
+
+class Line;
+
+// Interpolates between two frames. Each shape in one frame is paired with the
+// shape in the other whose position and length are closest, and both are
+// resampled to the same number of points. Shapes left without a partner grow
+// from, or shrink to, their centre.
+//
+// prepare() does all the allocation. morph() then only rewrites the points of a
+// frame of lines it owns, so it can run for every tween step at audio rate.
+class FrameMorpher {
+public:
+	explicit FrameMorpher(int segmentsPerShape = 16);
+
+	void prepare(const Frame& from, const Frame& to);
+
+	// Frame at amount between 0 (from) and 1 (to). The returned frame is owned by
+	// the morpher and rewritten by the next call.
+	const Frame& morph(float amount);
+	// Writes the same points to separate arrays, getNumPoints() of each.
+	void morph(float amount, float* x, float* y, float* z) const;
+
+	int getNumPoints() const { return (int) fromX.size(); }
+
+private:
+	struct ShapeSamples {
+		float centreX, centreY, centreZ;
+		float length;
+	};
+
+	void sample(const Frame& frame, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, std::vector<ShapeSamples>& shapes) const;
+
+	int segmentsPerShape;
+	// Points of each matched pair of shapes, segmentsPerShape + 1 per pair
+	std::vector<float> fromX, fromY, fromZ;
+	std::vector<float> toX, toY, toZ;
+
+	Frame output;
+	// The lines in output, to update without a virtual call or cast per line
+	std::vector<Line*> lines;
+};
+
+} // namespace osci
@@ -0,0 +1,333 @@
+#include "osci_FramePathOptimiser.h"
+#include "../shape/osci_Line.h"
+#include "../shape/osci_CubicBezierCurve.h"
+#include "../shape/osci_CircleArc.h"
+
+namespace osci {
+
+// Shapes whose ends are closer than this are drawn as one stroke and never separated.
+static constexpr float STROKE_JOIN_TOLERANCE = 1e-6f;
+// Nearest neighbour and each 2-opt pass take time quadratic in the number of
+// strokes. Above these limits 2-opt is skipped, and then nearest neighbour too,
+// leaving the strokes in frame order, so a dense frame still gets a path quickly.
+static constexpr size_t MAX_TWO_OPT_STROKES = 1000;
+static constexpr size_t MAX_NEAREST_NEIGHBOUR_STROKES = 10000;
+
+struct PathStroke {
+	uint32_t first, last;
+	float startX, startY, startZ;
+	float endX, endY, endZ;
+	bool reversible;
+};
+
+struct PathTourEntry {
+	uint32_t stroke;
+	bool flipped;
+};
+
+static float pathDistance(float x1, float y1, float z1, float x2, float y2, float z2) {
+	const float dx = x2 - x1, dy = y2 - y1, dz = z2 - z1;
+	return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+FramePathOptimiser::FramePathOptimiser(bool allowReversal, size_t cacheSize) : juce::Thread("Frame Path Optimiser"), allowReversal(allowReversal), cache(cacheSize) {
+	startThread();
+}
+
+FramePathOptimiser::~FramePathOptimiser() {
+	stopThread(2000);
+}
+
+std::vector<FramePathOptimiser::ShapeEnds> FramePathOptimiser::endsOf(const Frame& frame) {
+	std::vector<ShapeEnds> ends;
+	ends.reserve(frame.size());
+	for (auto& shape : frame) {
+		Point start = shape->nextVector(0);
+		Point end = shape->nextVector(1);
+		const bool reversible = dynamic_cast<Line*>(shape.get()) != nullptr
+			|| dynamic_cast<CubicBezierCurve*>(shape.get()) != nullptr
+			|| dynamic_cast<CircleArc*>(shape.get()) != nullptr
+			|| dynamic_cast<Point*>(shape.get()) != nullptr;
+		ends.push_back({ start.x, start.y, start.z, end.x, end.y, end.z, reversible });
+	}
+	return ends;
+}
+
+void FramePathOptimiser::reverseShape(Shape& shape) {
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		line->reverse();
+	} else if (auto curve = dynamic_cast<CubicBezierCurve*>(&shape)) {
+		curve->reverse();
+	} else if (auto arc = dynamic_cast<CircleArc*>(&shape)) {
+		arc->reverse();
+	}
+}
+
+FramePathOptimiser::Path FramePathOptimiser::computePath(const Frame& frame, bool allowReversal, int maxPasses) {
+	return computePath(endsOf(frame), allowReversal, maxPasses, nullptr);
+}
+
+FramePathOptimiser::Path FramePathOptimiser::computePath(const std::vector<ShapeEnds>& ends, bool allowReversal, int maxPasses, juce::Thread* thread) {
+	// Group runs of connected shapes into strokes
+	std::vector<PathStroke> strokes;
+	for (uint32_t i = 0; i < ends.size(); i++) {
+		const ShapeEnds& shape = ends[i];
+		if (!strokes.empty()) {
+			PathStroke& stroke = strokes.back();
+			if (pathDistance(stroke.endX, stroke.endY, stroke.endZ, shape.startX, shape.startY, shape.startZ) <= STROKE_JOIN_TOLERANCE) {
+				stroke.last = i;
+				stroke.endX = shape.endX;
+				stroke.endY = shape.endY;
+				stroke.endZ = shape.endZ;
+				stroke.reversible = stroke.reversible && shape.reversible;
+				continue;
+			}
+		}
+		strokes.push_back({ i, i, shape.startX, shape.startY, shape.startZ, shape.endX, shape.endY, shape.endZ, shape.reversible });
+	}
+
+	const size_t n = strokes.size();
+
+	auto startDistance = [&](const PathTourEntry& from, const PathTourEntry& to) {
+		const PathStroke& a = strokes[from.stroke];
+		const PathStroke& b = strokes[to.stroke];
+		const float* fromEnd = from.flipped ? &a.startX : &a.endX;
+		const float* toStart = to.flipped ? &b.endX : &b.startX;
+		return pathDistance(fromEnd[0], fromEnd[1], fromEnd[2], toStart[0], toStart[1], toStart[2]);
+	};
+	auto flip = [](PathTourEntry entry) {
+		entry.flipped = !entry.flipped;
+		return entry;
+	};
+
+	// Nearest neighbour seed, starting from the first stroke so the frame keeps its start
+	std::vector<PathTourEntry> tour;
+	tour.reserve(n);
+	if (n > MAX_NEAREST_NEIGHBOUR_STROKES) {
+		for (uint32_t s = 0; s < n; s++) {
+			tour.push_back({ s, false });
+		}
+	} else if (n > 0) {
+		std::vector<bool> visited(n, false);
+		tour.push_back({ 0, false });
+		visited[0] = true;
+
+		for (size_t k = 1; k < n; k++) {
+			const PathTourEntry current = tour.back();
+			PathTourEntry best = { 0, false };
+			float bestDistance = std::numeric_limits<float>::max();
+
+			for (uint32_t s = 0; s < n; s++) {
+				if (visited[s]) {
+					continue;
+				}
+				const float forward = startDistance(current, { s, false });
+				if (forward < bestDistance) {
+					bestDistance = forward;
+					best = { s, false };
+				}
+				if (allowReversal && strokes[s].reversible) {
+					const float backward = startDistance(current, { s, true });
+					if (backward < bestDistance) {
+						bestDistance = backward;
+						best = { s, true };
+					}
+				}
+			}
+
+			visited[best.stroke] = true;
+			tour.push_back(best);
+		}
+	}
+
+	// 2-opt over the closed tour. Reversing tour[i..j] either flips each stroke,
+	// which leaves the jumps inside the section unchanged, or keeps each stroke's
+	// direction, in which case the reversed internal jumps come from the prefix sums.
+	std::vector<double> forwardCost(n), reversedCost(n);
+	std::vector<uint32_t> reversibleCount(n + 1);
+
+	auto updatePrefixes = [&]() {
+		reversibleCount[0] = 0;
+		for (size_t k = 0; k < n; k++) {
+			reversibleCount[k + 1] = reversibleCount[k] + (strokes[tour[k].stroke].reversible ? 1 : 0);
+		}
+		forwardCost[0] = 0;
+		reversedCost[0] = 0;
+		for (size_t k = 1; k < n; k++) {
+			forwardCost[k] = forwardCost[k - 1] + startDistance(tour[k - 1], tour[k]);
+			reversedCost[k] = reversedCost[k - 1] + startDistance(tour[k], tour[k - 1]);
+		}
+	};
+
+	constexpr double minImprovement = 1e-6;
+
+	for (int pass = 0; pass < maxPasses && n > 2 && n <= MAX_TWO_OPT_STROKES; pass++) {
+		if (thread != nullptr && thread->threadShouldExit()) {
+			break;
+		}
+
+		bool improved = false;
+		updatePrefixes();
+
+		for (size_t i = 1; i < n; i++) {
+			for (size_t j = i; j < n; j++) {
+				const PathTourEntry& previous = tour[i - 1];
+				const PathTourEntry& next = tour[(j + 1) % n];
+				const double oldCost = startDistance(previous, tour[i]) + startDistance(tour[j], next);
+
+				double bestGain = minImprovement;
+				int bestMove = 0;
+
+				const bool canFlip = allowReversal && reversibleCount[j + 1] - reversibleCount[i] == j - i + 1;
+				if (canFlip) {
+					const double newCost = startDistance(previous, flip(tour[j])) + startDistance(flip(tour[i]), next);
+					if (oldCost - newCost > bestGain) {
+						bestGain = oldCost - newCost;
+						bestMove = 1;
+					}
+				}
+				if (j > i) {
+					const double internal = reversedCost[j] - reversedCost[i] - (forwardCost[j] - forwardCost[i]);
+					const double newCost = startDistance(previous, tour[j]) + startDistance(tour[i], next) + internal;
+					if (oldCost - newCost > bestGain) {
+						bestGain = oldCost - newCost;
+						bestMove = 2;
+					}
+				}
+
+				if (bestMove != 0) {
+					std::reverse(tour.begin() + i, tour.begin() + j + 1);
+					if (bestMove == 1) {
+						for (size_t k = i; k <= j; k++) {
+							tour[k].flipped = !tour[k].flipped;
+						}
+					}
+					updatePrefixes();
+					improved = true;
+				}
+			}
+		}
+
+		if (!improved) {
+			break;
+		}
+	}
+
+	Path path;
+	path.reserve(ends.size());
+	for (const PathTourEntry& entry : tour) {
+		const PathStroke& stroke = strokes[entry.stroke];
+		if (entry.flipped) {
+			for (uint32_t s = stroke.last + 1; s-- > stroke.first;) {
+				path.push_back({ s, true });
+			}
+		} else {
+			for (uint32_t s = stroke.first; s <= stroke.last; s++) {
+				path.push_back({ s, false });
+			}
+		}
+	}
+	return path;
+}
+
+bool FramePathOptimiser::applyPath(Frame& frame, const Path& path) {
+	if (path.size() != frame.size()) {
+		return false;
+	}
+
+	std::vector<bool> used(frame.size(), false);
+	for (const Step& step : path) {
+		// A different frame with the same hash
+		if (step.shape >= frame.size() || used[step.shape]) {
+			return false;
+		}
+		used[step.shape] = true;
+	}
+
+	Frame reordered;
+	reordered.reserve(frame.size());
+	for (const Step& step : path) {
+		if (step.reversed) {
+			reverseShape(*frame[step.shape]);
+		}
+		reordered.push_back(std::move(frame[step.shape]));
+	}
+
+	frame = std::move(reordered);
+	return true;
+}
+
+float FramePathOptimiser::travel(const Frame& frame) {
+	if (frame.empty()) {
+		return 0;
+	}
+
+	float total = 0;
+	Point previousEnd = frame.back()->nextVector(1);
+	for (auto& shape : frame) {
+		Point start = shape->nextVector(0);
+		total += pathDistance(previousEnd.x, previousEnd.y, previousEnd.z, start.x, start.y, start.z);
+		previousEnd = shape->nextVector(1);
+	}
+	return total;
+}
+
+bool FramePathOptimiser::optimise(Frame& frame) {
+	const uint64_t hash = hashFrame(frame);
+	std::shared_ptr<const Path> path;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (auto cached = cache.find(hash)) {
+			path = *cached;
+		}
+	}
+	if (path != nullptr) {
+		return applyPath(frame, *path);
+	}
+
+	std::vector<ShapeEnds> ends = endsOf(frame);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (hashInProgress == hash || (hasPendingRequest && pendingHash == hash)) {
+			return false;
+		}
+		hasPendingRequest = true;
+		pendingHash = hash;
+		pendingEnds = std::move(ends);
+	}
+	notify();
+	return false;
+}
+
+void FramePathOptimiser::run() {
+	while (!threadShouldExit()) {
+		uint64_t hash = 0;
+		std::vector<ShapeEnds> ends;
+		bool hasRequest = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (hasPendingRequest) {
+				hash = pendingHash;
+				ends = std::move(pendingEnds);
+				hasPendingRequest = false;
+				hashInProgress = hash;
+				hasRequest = true;
+			}
+		}
+
+		if (!hasRequest) {
+			wait(-1);
+			continue;
+		}
+
+		auto path = std::make_shared<const Path>(computePath(ends, allowReversal, 8, this));
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!threadShouldExit()) {
+			cache.insert(hash, std::move(path));
+		}
+		hashInProgress.reset();
+	}
+}
+
+} // namespace osci
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <mutex>
+#include "osci_Frame.h"
+#include "osci_LruCache.h"
+
+namespace osci {
+
+// Reorders the shapes in a frame to cut down the distance the beam jumps between
+// disconnected strokes. Connected runs of shapes are kept together as strokes,
+// which are ordered by nearest neighbour and then improved with 2-opt. Both are
+// quadratic in the number of strokes, so frames with thousands of strokes only
+// get nearest neighbour, and far larger ones keep their order. Lines, cubic
+// curves and arcs can also be drawn backwards when that shortens a jump.
+//
+// Paths are computed on a background thread and cached by frame hash, so a frame
+// that repeats is reordered with no more than a lookup and a pass over its shapes.
+class FramePathOptimiser : private juce::Thread {
+public:
+	struct Step {
+		uint32_t shape;
+		bool reversed;
+	};
+	typedef std::vector<Step> Path;
+
+	explicit FramePathOptimiser(bool allowReversal = true, size_t cacheSize = 32);
+	~FramePathOptimiser() override;
+
+	// Reorders the frame using its cached path and returns true. If no path is
+	// cached yet, one is requested in the background and the frame is unchanged.
+	bool optimise(Frame& frame);
+
+	static Path computePath(const Frame& frame, bool allowReversal, int maxPasses = 8);
+	// Returns false, leaving the frame unchanged, if the path doesn't fit it.
+	static bool applyPath(Frame& frame, const Path& path);
+	// Total distance jumped between the end of each shape and the start of the
+	// next, including the jump back to the start when the frame repeats.
+	static float travel(const Frame& frame);
+
+private:
+	struct ShapeEnds {
+		float startX, startY, startZ;
+		float endX, endY, endZ;
+		bool reversible;
+	};
+
+	static std::vector<ShapeEnds> endsOf(const Frame& frame);
+	// thread, when given, is checked between 2-opt sweeps so shutdown isn't held up.
+	static Path computePath(const std::vector<ShapeEnds>& ends, bool allowReversal, int maxPasses, juce::Thread* thread);
+	static void reverseShape(Shape& shape);
+
+	void run() override;
+
+	const bool allowReversal;
+
+	std::mutex mutex;
+	LruCache<uint64_t, std::shared_ptr<const Path>> cache;
+
+	// The latest frame waiting for a path. Older requests are replaced.
+	bool hasPendingRequest = false;
+	uint64_t pendingHash = 0;
+	std::vector<ShapeEnds> pendingEnds;
+	std::optional<uint64_t> hashInProgress;
+};
+
+} // namespace osci
@@ -0,0 +1,296 @@
+#include "osci_FrameSequence.h"
+
+namespace osci {
+
+// A delta costs 8 bytes per change against 4 per coordinate in a keyframe, so it
+// only pays off when well under half the coordinates have changed.
+static constexpr size_t MAX_DELTA_FRACTION = 4;
+
+static size_t numCoordinates(const ShapeBuffer& frame) {
+	size_t count = 0;
+	for (auto array : frame.coordinateArrays()) {
+		count += array->size();
+	}
+	return count;
+}
+
+FrameSequence::FrameSequence(int keyframeInterval, float tolerance) : keyframeInterval(std::max(1, keyframeInterval)), tolerance(std::max(0.0f, tolerance)) {}
+
+void FrameSequence::clear() {
+	keyframes.clear();
+	keyframeStarts.clear();
+	entries.clear();
+	transforms.clear();
+	previous.clear();
+	framesSinceKeyframe = 0;
+	current.clear();
+	currentIndex = -1;
+}
+
+bool FrameSequence::computeDelta(const ShapeBuffer& from, const ShapeBuffer& to, size_t maxChanges, Delta& delta) {
+	if (!from.hasSameLayout(to)) {
+		return false;
+	}
+
+	auto fromArrays = from.coordinateArrays();
+	auto toArrays = to.coordinateArrays();
+
+	for (int array = 0; array < ShapeBuffer::NUM_COORDINATE_ARRAYS; array++) {
+		const std::vector<float>& a = *fromArrays[array];
+		const std::vector<float>& b = *toArrays[array];
+		if (b.size() > ELEMENT_MASK) {
+			return false;
+		}
+		for (size_t i = 0; i < b.size(); i++) {
+			// Compared bitwise so that deltas are exact, including for NaN and -0
+			if (std::memcmp(&a[i], &b[i], sizeof(float)) != 0) {
+				if (delta.positions.size() == maxChanges) {
+					return false;
+				}
+				delta.positions.push_back(((uint32_t) array << ELEMENT_BITS) | (uint32_t) i);
+				delta.values.push_back(b[i]);
+			}
+		}
+	}
+	return true;
+}
+
+void FrameSequence::applyDelta(ShapeBuffer& frame, const Delta& delta) {
+	if (delta.positions.empty()) {
+		return;
+	}
+
+	auto arrays = frame.coordinateArrays();
+	for (size_t i = 0; i < delta.positions.size(); i++) {
+		const uint32_t position = delta.positions[i];
+		(*arrays[position >> ELEMENT_BITS])[position & ELEMENT_MASK] = delta.values[i];
+	}
+	frame.invalidateLengths();
+}
+
+// Accumulates the normal equations for a least squares fit of each output
+// coordinate as an affine function of the input point.
+struct TransformFit {
+	double normal[4][4] = {};
+	double rhs[3][4] = {};
+
+	void add(double x, double y, double z, double toX, double toY, double toZ) {
+		const double v[4] = { x, y, z, 1 };
+		const double to[3] = { toX, toY, toZ };
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				normal[i][j] += v[i] * v[j];
+			}
+			for (int row = 0; row < 3; row++) {
+				rhs[row][i] += v[i] * to[row];
+			}
+		}
+	}
+
+	Transform3D solve() {
+		// A slight pull towards the identity settles directions the points don't
+		// span, such as z when every point is on the plane.
+		const Transform3D identity;
+		const double trace = normal[0][0] + normal[1][1] + normal[2][2] + normal[3][3];
+		const double ridge = 1e-9 * trace + 1e-12;
+		for (int i = 0; i < 4; i++) {
+			normal[i][i] += ridge;
+			for (int row = 0; row < 3; row++) {
+				rhs[row][i] += ridge * identity.m[row][i];
+			}
+		}
+
+		// Gaussian elimination with partial pivoting, for all three rows at once
+		for (int column = 0; column < 4; column++) {
+			int pivot = column;
+			for (int i = column + 1; i < 4; i++) {
+				if (std::abs(normal[i][column]) > std::abs(normal[pivot][column])) {
+					pivot = i;
+				}
+			}
+			std::swap(normal[column], normal[pivot]);
+			for (int row = 0; row < 3; row++) {
+				std::swap(rhs[row][column], rhs[row][pivot]);
+			}
+			for (int i = column + 1; i < 4; i++) {
+				const double factor = normal[i][column] / normal[column][column];
+				for (int j = column; j < 4; j++) {
+					normal[i][j] -= factor * normal[column][j];
+				}
+				for (int row = 0; row < 3; row++) {
+					rhs[row][i] -= factor * rhs[row][column];
+				}
+			}
+		}
+
+		Transform3D transform;
+		for (int row = 0; row < 3; row++) {
+			double w[4];
+			for (int i = 3; i >= 0; i--) {
+				double sum = rhs[row][i];
+				for (int j = i + 1; j < 4; j++) {
+					sum -= normal[i][j] * w[j];
+				}
+				w[i] = sum / normal[i][i];
+			}
+			for (int i = 0; i < 4; i++) {
+				transform.m[row][i] = (float) w[i];
+			}
+		}
+		return transform;
+	}
+};
+
+Transform3D FrameSequence::fitTransform(const ShapeBuffer& from, const ShapeBuffer& to) {
+	TransformFit fit;
+	const auto& a = from.lines;
+	const auto& b = to.lines;
+	for (size_t i = 0; i < a.x1.size(); i++) {
+		fit.add(a.x1[i], a.y1[i], a.z1[i], b.x1[i], b.y1[i], b.z1[i]);
+		fit.add(a.x2[i], a.y2[i], a.z2[i], b.x2[i], b.y2[i], b.z2[i]);
+	}
+	const auto& c = from.curves;
+	const auto& d = to.curves;
+	for (size_t i = 0; i < c.x1.size(); i++) {
+		fit.add(c.x1[i], c.y1[i], 0, d.x1[i], d.y1[i], 0);
+		fit.add(c.x2[i], c.y2[i], 0, d.x2[i], d.y2[i], 0);
+		fit.add(c.x3[i], c.y3[i], 0, d.x3[i], d.y3[i], 0);
+		fit.add(c.x4[i], c.y4[i], 0, d.x4[i], d.y4[i], 0);
+	}
+	for (size_t i = 0; i < from.arcs.x.size(); i++) {
+		fit.add(from.arcs.x[i], from.arcs.y[i], 0, to.arcs.x[i], to.arcs.y[i], 0);
+	}
+	return fit.solve();
+}
+
+void FrameSequence::transformPoints(ShapeBuffer& frame, const Transform3D& transform) {
+	auto& lines = frame.lines;
+	const int numLines = (int) lines.x1.size();
+	transform.apply(lines.x1.data(), lines.y1.data(), lines.z1.data(), numLines);
+	transform.apply(lines.x2.data(), lines.y2.data(), lines.z2.data(), numLines);
+
+	auto& curves = frame.curves;
+	const int numCurves = (int) curves.x1.size();
+	transform.applyToPlane(curves.x1.data(), curves.y1.data(), numCurves);
+	transform.applyToPlane(curves.x2.data(), curves.y2.data(), numCurves);
+	transform.applyToPlane(curves.x3.data(), curves.y3.data(), numCurves);
+	transform.applyToPlane(curves.x4.data(), curves.y4.data(), numCurves);
+
+	transform.applyToPlane(frame.arcs.x.data(), frame.arcs.y.data(), (int) frame.arcs.x.size());
+	frame.invalidateLengths();
+}
+
+bool FrameSequence::computeTransformDelta(const ShapeBuffer& keyframe, const ShapeBuffer& to, size_t maxChanges, Transform3D& transform, Delta& delta) {
+	if (!keyframe.hasSameLayout(to)) {
+		return false;
+	}
+
+	transform = fitTransform(keyframe, to);
+	predicted = keyframe;
+	transformPoints(predicted, transform);
+
+	auto predictedArrays = predicted.coordinateArrays();
+	auto toArrays = to.coordinateArrays();
+
+	for (int array = 0; array < ShapeBuffer::NUM_COORDINATE_ARRAYS; array++) {
+		const std::vector<float>& a = *predictedArrays[array];
+		const std::vector<float>& b = *toArrays[array];
+		if (b.size() > ELEMENT_MASK) {
+			return false;
+		}
+		for (size_t i = 0; i < b.size(); i++) {
+			// NaN is never close, so it is always kept
+			const bool close = tolerance > 0 ? std::abs(a[i] - b[i]) <= tolerance : std::memcmp(&a[i], &b[i], sizeof(float)) == 0;
+			if (!close) {
+				if (delta.positions.size() == maxChanges) {
+					return false;
+				}
+				delta.positions.push_back(((uint32_t) array << ELEMENT_BITS) | (uint32_t) i);
+				delta.values.push_back(b[i]);
+			}
+		}
+	}
+	return true;
+}
+
+void FrameSequence::add(const ShapeBuffer& frame) {
+	Entry entry;
+	bool isKeyframe = keyframes.empty() || framesSinceKeyframe + 1 >= keyframeInterval;
+	if (!isKeyframe) {
+		const size_t maxChanges = numCoordinates(frame) / MAX_DELTA_FRACTION;
+		isKeyframe = !computeDelta(previous, frame, maxChanges, entry.delta);
+		if (isKeyframe) {
+			Transform3D transform;
+			entry.delta = Delta();
+			if (computeTransformDelta(keyframes.back(), frame, maxChanges, transform, entry.delta)) {
+				isKeyframe = false;
+				entry.transform = (int) transforms.size();
+				transforms.push_back(transform);
+			}
+		}
+	}
+
+	if (isKeyframe) {
+		entry.delta = Delta();
+		keyframes.push_back(frame);
+		keyframeStarts.push_back((int) entries.size());
+		framesSinceKeyframe = 0;
+	} else {
+		entry.delta.positions.shrink_to_fit();
+		entry.delta.values.shrink_to_fit();
+		framesSinceKeyframe++;
+	}
+	entry.keyframe = (int) keyframes.size() - 1;
+	entries.push_back(std::move(entry));
+
+	previous = frame;
+}
+
+size_t FrameSequence::memoryUsage() const {
+	size_t bytes = entries.size() * sizeof(Entry) + transforms.size() * sizeof(Transform3D);
+	for (auto& keyframe : keyframes) {
+		bytes += keyframe.size() * (sizeof(ShapeBuffer::Tag) + sizeof(uint32_t) + sizeof(float));
+		bytes += numCoordinates(keyframe) * sizeof(float);
+	}
+	for (auto& entry : entries) {
+		bytes += entry.delta.positions.size() * (sizeof(uint32_t) + sizeof(float));
+	}
+	return bytes;
+}
+
+const ShapeBuffer& FrameSequence::frame(int index) {
+	jassert(index >= 0 && index < size());
+	if (index == currentIndex) {
+		return current;
+	}
+
+	const Entry& entry = entries[index];
+	int next;
+	if (currentIndex >= 0 && currentIndex < index && entries[currentIndex].keyframe == entry.keyframe) {
+		// Playing forward, usually by one frame
+		next = currentIndex + 1;
+	} else {
+		current = keyframes[entry.keyframe];
+		next = keyframeStarts[entry.keyframe] + 1;
+	}
+
+	// Frames before the last transformed one don't contribute to it
+	for (int i = index; i >= next; i--) {
+		if (entries[i].transform >= 0) {
+			next = i;
+			break;
+		}
+	}
+
+	for (int i = next; i <= index; i++) {
+		if (entries[i].transform >= 0) {
+			current = keyframes[entry.keyframe];
+			transformPoints(current, transforms[entries[i].transform]);
+		}
+		applyDelta(current, entries[i].delta);
+	}
+	currentIndex = index;
+	return current;
+}
+
+} // namespace osci
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "osci_ShapeBuffer.h"
+
+namespace osci {
+
+// Animation stored as keyframes plus, for every other frame, the coordinates that
+// changed since the frame before it. When too many have changed, e.g. because the
+// whole frame moved, the frame is instead stored as a transform of its keyframe
+// plus the coordinates the transform doesn't predict. A new keyframe is started
+// when the shapes themselves change, when neither kind of delta would be much
+// smaller than the frame, or every keyframeInterval frames to bound the cost of
+// seeking.
+//
+// Playing frames in order applies one delta per frame to the previous frame.
+// Coordinate deltas are lossless. Transformed coordinates within tolerance of the
+// frame added are kept, so with the default tolerance of 0 reconstructed frames
+// match those added exactly, but only exact transforms such as translations by
+// representable amounts pay off. A small tolerance lets rotations and scales of
+// the keyframe be stored as transforms too.
+class FrameSequence {
+public:
+	explicit FrameSequence(int keyframeInterval = 32, float tolerance = 0.0f);
+
+	void add(const ShapeBuffer& frame);
+	void clear();
+
+	int size() const { return (int) entries.size(); }
+	int getNumKeyframes() const { return (int) keyframes.size(); }
+	int getNumTransformedFrames() const { return (int) transforms.size(); }
+	// Approximate bytes used by stored keyframes and deltas.
+	size_t memoryUsage() const;
+
+	// Reconstructs the frame. The returned buffer is reused by the next call.
+	const ShapeBuffer& frame(int index);
+
+private:
+	struct Delta {
+		// Each changed coordinate: its array in the high bits, element in the low bits
+		std::vector<uint32_t> positions;
+		std::vector<float> values;
+	};
+
+	struct Entry {
+		int keyframe;
+		// Index into transforms when the delta is against the transformed keyframe
+		// rather than the previous frame, or -1
+		int transform = -1;
+		Delta delta;
+	};
+
+	static constexpr int ELEMENT_BITS = 27;
+	static constexpr uint32_t ELEMENT_MASK = (1u << ELEMENT_BITS) - 1;
+
+	static bool computeDelta(const ShapeBuffer& from, const ShapeBuffer& to, size_t maxChanges, Delta& delta);
+	static void applyDelta(ShapeBuffer& frame, const Delta& delta);
+	// Least squares affine transform taking the points of from onto those of to
+	static Transform3D fitTransform(const ShapeBuffer& from, const ShapeBuffer& to);
+	// Transforms the points of frame, leaving arc radii and angles to the delta
+	static void transformPoints(ShapeBuffer& frame, const Transform3D& transform);
+	bool computeTransformDelta(const ShapeBuffer& keyframe, const ShapeBuffer& to, size_t maxChanges, Transform3D& transform, Delta& delta);
+
+	int keyframeInterval;
+	float tolerance;
+	std::vector<ShapeBuffer> keyframes;
+	// Entry index of each keyframe
+	std::vector<int> keyframeStarts;
+	std::vector<Entry> entries;
+	std::vector<Transform3D> transforms;
+
+	// Last frame added, which the next delta is taken against
+	ShapeBuffer previous;
+	int framesSinceKeyframe = 0;
+	// Scratch for the transformed keyframe a transform delta is taken against
+	ShapeBuffer predicted;
+
+	ShapeBuffer current;
+	int currentIndex = -1;
+};
+
+} // namespace osci
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+namespace osci {
+
+// Fixed-capacity map that evicts the least recently used entry. Not thread-safe;
+// owners guard it with their own mutex.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+	explicit LruCache(size_t capacity) : capacity(capacity) {}
+
+	// Returns nullptr when the key isn't cached. Otherwise marks it as most recently used.
+	const Value* find(const Key& key) {
+		auto it = index.find(key);
+		if (it == index.end()) {
+			return nullptr;
+		}
+		entries.splice(entries.begin(), entries, it->second);
+		return &it->second->second;
+	}
+
+	void insert(const Key& key, Value value) {
+		auto it = index.find(key);
+		if (it != index.end()) {
+			entries.erase(it->second);
+		}
+		entries.emplace_front(key, std::move(value));
+		index[key] = entries.begin();
+
+		while (entries.size() > capacity) {
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+	}
+
+	void clear() {
+		entries.clear();
+		index.clear();
+	}
+
+	size_t size() const { return entries.size(); }
+
+private:
+	size_t capacity;
+	// Most recently used first
+	std::list<std::pair<Key, Value>> entries;
+	std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator, Hash> index;
+};
+
+} // namespace osci
@@ -0,0 +1,95 @@
+#include "osci_QuantisedFrame.h"
+#include "../osci_Util.h"
+
+namespace osci {
+
+QuantisedFrame::QuantisedFrame(const ShapeBuffer& buffer) {
+	encode(buffer);
+}
+
+static float maxMagnitude(const std::vector<float>& values) {
+	float magnitude = 0;
+	for (float value : values) {
+		magnitude = std::max(magnitude, std::abs(value));
+	}
+	return magnitude;
+}
+
+void QuantisedFrame::encode(const ShapeBuffer& buffer) {
+	const auto source = buffer.coordinateArrays();
+
+	range = 0;
+	for (int array = 0; array < ShapeBuffer::NUM_QUANTISABLE_ARRAYS; array++) {
+		range = std::max(range, maxMagnitude(*source[array]));
+	}
+	range = range > 0 ? range : 1;
+
+	hasLineZ = maxMagnitude(*source[ShapeBuffer::LINE_Z1_ARRAY]) > 0 || maxMagnitude(*source[ShapeBuffer::LINE_Z2_ARRAY]) > 0;
+
+	for (int array = 0; array < ShapeBuffer::NUM_QUANTISABLE_ARRAYS; array++) {
+		const std::vector<float>& values = *source[array];
+		counts[array] = (uint32_t) values.size();
+		if (!hasLineZ && (array == ShapeBuffer::LINE_Z1_ARRAY || array == ShapeBuffer::LINE_Z2_ARRAY)) {
+			arrays[array].clear();
+			continue;
+		}
+		arrays[array].resize(values.size());
+		Util::quantise(values.data(), arrays[array].data(), values.size(), range);
+	}
+	startAngles = *source[ShapeBuffer::ARC_START_ANGLE_ARRAY];
+	endAngles = *source[ShapeBuffer::ARC_END_ANGLE_ARRAY];
+
+	tags.resize(buffer.size());
+	indices.clear();
+	uint32_t next[3] = { 0, 0, 0 };
+	bool canonical = true;
+	for (size_t i = 0; i < buffer.size(); i++) {
+		tags[i] = buffer.tag(i);
+		canonical = canonical && buffer.kindIndex(i) == next[(int) tags[i]]++;
+	}
+	if (!canonical) {
+		indices.resize(buffer.size());
+		for (size_t i = 0; i < buffer.size(); i++) {
+			indices[i] = buffer.kindIndex(i);
+		}
+	}
+}
+
+void QuantisedFrame::decode(ShapeBuffer& buffer) const {
+	buffer.tags = tags;
+	buffer.lengths.assign(tags.size(), Shape::INVALID_LENGTH);
+
+	if (indices.empty()) {
+		buffer.indices.resize(tags.size());
+		uint32_t next[3] = { 0, 0, 0 };
+		for (size_t i = 0; i < tags.size(); i++) {
+			buffer.indices[i] = next[(int) tags[i]]++;
+		}
+	} else {
+		buffer.indices = indices;
+	}
+
+	const auto destination = buffer.coordinateArrays();
+	for (int array = 0; array < ShapeBuffer::NUM_QUANTISABLE_ARRAYS; array++) {
+		std::vector<float>& values = *destination[array];
+		values.resize(counts[array]);
+		if (arrays[array].size() == counts[array]) {
+			Util::dequantise(arrays[array].data(), values.data(), counts[array], range);
+		} else {
+			std::fill(values.begin(), values.end(), 0.0f);
+		}
+	}
+	*destination[ShapeBuffer::ARC_START_ANGLE_ARRAY] = startAngles;
+	*destination[ShapeBuffer::ARC_END_ANGLE_ARRAY] = endAngles;
+}
+
+size_t QuantisedFrame::memoryUsage() const {
+	size_t bytes = sizeof(*this) + tags.size() * sizeof(ShapeBuffer::Tag) + indices.size() * sizeof(uint32_t);
+	for (auto& array : arrays) {
+		bytes += array.size() * sizeof(int16_t);
+	}
+	bytes += (startAngles.size() + endAngles.size()) * sizeof(float);
+	return bytes;
+}
+
+} // namespace osci
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "osci_ShapeBuffer.h"
+
+namespace osci {
+
+// ShapeBuffer stored with 16-bit coordinates, for keeping large numbers of frames
+// in memory. Coordinates are scaled to the largest magnitude in the frame, which
+// after Shape::normalize is at most 1. Arc angles are kept as floats, as they are
+// in quantised FrameFiles.
+// Line z values are dropped when they're all zero, and kind indices when they
+// just count up through each kind, as they do for buffers built by adding shapes.
+//
+// Decoding is one branch-free pass per array into a ShapeBuffer that can be
+// reused between frames, which the compiler vectorises.
+class QuantisedFrame {
+public:
+	QuantisedFrame() = default;
+	explicit QuantisedFrame(const ShapeBuffer& buffer);
+
+	void encode(const ShapeBuffer& buffer);
+	void decode(ShapeBuffer& buffer) const;
+
+	size_t size() const { return tags.size(); }
+	bool empty() const { return tags.empty(); }
+	size_t memoryUsage() const;
+
+private:
+	std::vector<ShapeBuffer::Tag> tags;
+	// Empty when each shape's index is the number of earlier shapes of its kind
+	std::vector<uint32_t> indices;
+	std::array<std::vector<int16_t>, ShapeBuffer::NUM_QUANTISABLE_ARRAYS> arrays;
+	std::array<uint32_t, ShapeBuffer::NUM_QUANTISABLE_ARRAYS> counts{};
+	std::vector<float> startAngles;
+	std::vector<float> endAngles;
+	float range = 1;
+	bool hasLineZ = false;
+};
+
+} // namespace osci
@@ -0,0 +1,666 @@
+#include "osci_ShapeBuffer.h"
+#include "../shape/osci_Line.h"
+#include "../shape/osci_CubicBezierCurve.h"
+#include "../shape/osci_CircleArc.h"
+#include "../shape/osci_Clipper.h"
+#include <numbers>
+
+namespace osci {
+
+ShapeBuffer::ShapeBuffer(const Frame& frame) {
+	assign(frame);
+}
+
+void ShapeBuffer::clear() {
+	tags.clear();
+	indices.clear();
+	lengths.clear();
+
+	lines = Lines();
+	curves = CubicBezierCurves();
+	arcs = CircleArcs();
+}
+
+void ShapeBuffer::reserve(size_t numShapes) {
+	tags.reserve(numShapes);
+	indices.reserve(numShapes);
+	lengths.reserve(numShapes);
+}
+
+void ShapeBuffer::push(Tag tag, size_t kindSize) {
+	tags.push_back(tag);
+	indices.push_back(static_cast<uint32_t>(kindSize - 1));
+	lengths.push_back(Shape::INVALID_LENGTH);
+}
+
+void ShapeBuffer::addLine(float x1, float y1, float z1, float x2, float y2, float z2) {
+	lines.x1.push_back(x1);
+	lines.y1.push_back(y1);
+	lines.z1.push_back(z1);
+	lines.x2.push_back(x2);
+	lines.y2.push_back(y2);
+	lines.z2.push_back(z2);
+	push(Tag::Line, lines.x1.size());
+}
+
+void ShapeBuffer::addCubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) {
+	curves.x1.push_back(x1);
+	curves.y1.push_back(y1);
+	curves.x2.push_back(x2);
+	curves.y2.push_back(y2);
+	curves.x3.push_back(x3);
+	curves.y3.push_back(y3);
+	curves.x4.push_back(x4);
+	curves.y4.push_back(y4);
+	push(Tag::CubicBezierCurve, curves.x1.size());
+}
+
+void ShapeBuffer::addCircleArc(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle) {
+	arcs.x.push_back(x);
+	arcs.y.push_back(y);
+	arcs.radiusX.push_back(radiusX);
+	arcs.radiusY.push_back(radiusY);
+	arcs.startAngle.push_back(startAngle);
+	arcs.endAngle.push_back(endAngle);
+	push(Tag::CircleArc, arcs.x.size());
+}
+
+void ShapeBuffer::add(Shape& shape) {
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		addLine(line->x1, line->y1, line->z1, line->x2, line->y2, line->z2);
+	} else if (auto curve = dynamic_cast<CubicBezierCurve*>(&shape)) {
+		addCubicBezierCurve(curve->x1, curve->y1, curve->x2, curve->y2, curve->x3, curve->y3, curve->x4, curve->y4);
+	} else if (auto arc = dynamic_cast<CircleArc*>(&shape)) {
+		addCircleArc(arc->x, arc->y, arc->radiusX, arc->radiusY, arc->startAngle, arc->endAngle);
+	} else if (auto point = dynamic_cast<Point*>(&shape)) {
+		addLine(point->x, point->y, point->z, point->x, point->y, point->z);
+	} else {
+		const int segments = 8;
+		Point start = shape.nextVector(0);
+		for (int i = 1; i <= segments; i++) {
+			Point end = shape.nextVector(i / (float) segments);
+			addLine(start.x, start.y, start.z, end.x, end.y, end.z);
+			start = end;
+		}
+	}
+}
+
+void ShapeBuffer::assign(const Frame& frame) {
+	clear();
+	reserve(frame.size());
+	for (auto& shape : frame) {
+		add(*shape);
+	}
+}
+
+void ShapeBuffer::assign(const ShapeBufferView& view) {
+	tags.assign(view.tags, view.tags + view.numShapes);
+	indices.assign(view.indices, view.indices + view.numShapes);
+	lengths.assign(view.numShapes, Shape::INVALID_LENGTH);
+
+	auto copy = [](std::vector<float>& destination, const float* source, size_t count) {
+		destination.assign(source, source + count);
+	};
+
+	copy(lines.x1, view.lines.x1, view.numLines);
+	copy(lines.y1, view.lines.y1, view.numLines);
+	copy(lines.z1, view.lines.z1, view.numLines);
+	copy(lines.x2, view.lines.x2, view.numLines);
+	copy(lines.y2, view.lines.y2, view.numLines);
+	copy(lines.z2, view.lines.z2, view.numLines);
+
+	copy(curves.x1, view.curves.x1, view.numCurves);
+	copy(curves.y1, view.curves.y1, view.numCurves);
+	copy(curves.x2, view.curves.x2, view.numCurves);
+	copy(curves.y2, view.curves.y2, view.numCurves);
+	copy(curves.x3, view.curves.x3, view.numCurves);
+	copy(curves.y3, view.curves.y3, view.numCurves);
+	copy(curves.x4, view.curves.x4, view.numCurves);
+	copy(curves.y4, view.curves.y4, view.numCurves);
+
+	copy(arcs.x, view.arcs.x, view.numArcs);
+	copy(arcs.y, view.arcs.y, view.numArcs);
+	copy(arcs.radiusX, view.arcs.radiusX, view.numArcs);
+	copy(arcs.radiusY, view.arcs.radiusY, view.numArcs);
+	copy(arcs.startAngle, view.arcs.startAngle, view.numArcs);
+	copy(arcs.endAngle, view.arcs.endAngle, view.numArcs);
+}
+
+// Sampling shared by ShapeBuffer and ShapeBufferView, which lay out their
+// coordinates the same way but in vectors and raw arrays respectively.
+template <typename Storage>
+static Frame toFrameOf(const Storage& s, const ShapeBuffer::Tag* tags, const uint32_t* indices, size_t size) {
+	Frame frame;
+	frame.reserve(size);
+
+	for (size_t i = 0; i < size; i++) {
+		const uint32_t k = indices[i];
+		switch (tags[i]) {
+			case ShapeBuffer::Tag::Line:
+				frame.push_back(std::make_unique<Line>(s.lines.x1[k], s.lines.y1[k], s.lines.z1[k], s.lines.x2[k], s.lines.y2[k], s.lines.z2[k]));
+				break;
+			case ShapeBuffer::Tag::CubicBezierCurve:
+				frame.push_back(std::make_unique<CubicBezierCurve>(s.curves.x1[k], s.curves.y1[k], s.curves.x2[k], s.curves.y2[k], s.curves.x3[k], s.curves.y3[k], s.curves.x4[k], s.curves.y4[k]));
+				break;
+			case ShapeBuffer::Tag::CircleArc:
+				frame.push_back(std::make_unique<CircleArc>(s.arcs.x[k], s.arcs.y[k], s.arcs.radiusX[k], s.arcs.radiusY[k], s.arcs.startAngle[k], s.arcs.endAngle[k]));
+				break;
+		}
+	}
+
+	return frame;
+}
+
+template <typename Storage>
+static Point nextVectorOf(const Storage& s, ShapeBuffer::Tag tag, uint32_t k, float t) {
+	switch (tag) {
+		case ShapeBuffer::Tag::Line:
+			return Point(
+				s.lines.x1[k] + (s.lines.x2[k] - s.lines.x1[k]) * t,
+				s.lines.y1[k] + (s.lines.y2[k] - s.lines.y1[k]) * t,
+				s.lines.z1[k] + (s.lines.z2[k] - s.lines.z1[k]) * t
+			);
+		case ShapeBuffer::Tag::CubicBezierCurve: {
+			const float u = 1 - t;
+			const float b0 = u * u * u;
+			const float b1 = 3 * u * u * t;
+			const float b2 = 3 * u * t * t;
+			const float b3 = t * t * t;
+			return Point(
+				b0 * s.curves.x1[k] + b1 * s.curves.x2[k] + b2 * s.curves.x3[k] + b3 * s.curves.x4[k],
+				b0 * s.curves.y1[k] + b1 * s.curves.y2[k] + b2 * s.curves.y3[k] + b3 * s.curves.y4[k]
+			);
+		}
+		case ShapeBuffer::Tag::CircleArc: {
+			const float angle = s.arcs.startAngle[k] + s.arcs.endAngle[k] * t;
+			return Point(
+				s.arcs.x[k] + s.arcs.radiusX[k] * std::cos(angle),
+				s.arcs.y[k] + s.arcs.radiusY[k] * std::sin(angle)
+			);
+		}
+	}
+	return Point();
+}
+
+template <typename Storage>
+static void sampleBlockOf(const Storage& s, ShapeBuffer::Tag tag, uint32_t k, const float* t, int n, float* x, float* y, float* z) {
+	switch (tag) {
+		case ShapeBuffer::Tag::Line: {
+			const float x1 = s.lines.x1[k], y1 = s.lines.y1[k], z1 = s.lines.z1[k];
+			const float dx = s.lines.x2[k] - x1, dy = s.lines.y2[k] - y1, dz = s.lines.z2[k] - z1;
+			for (int i = 0; i < n; i++) {
+				x[i] = x1 + dx * t[i];
+				y[i] = y1 + dy * t[i];
+				z[i] = z1 + dz * t[i];
+			}
+			break;
+		}
+		case ShapeBuffer::Tag::CubicBezierCurve: {
+			const float x1 = s.curves.x1[k], x2 = s.curves.x2[k], x3 = s.curves.x3[k], x4 = s.curves.x4[k];
+			const float y1 = s.curves.y1[k], y2 = s.curves.y2[k], y3 = s.curves.y3[k], y4 = s.curves.y4[k];
+			for (int i = 0; i < n; i++) {
+				const float u = 1 - t[i];
+				const float b0 = u * u * u;
+				const float b1 = 3 * u * u * t[i];
+				const float b2 = 3 * u * t[i] * t[i];
+				const float b3 = t[i] * t[i] * t[i];
+				x[i] = b0 * x1 + b1 * x2 + b2 * x3 + b3 * x4;
+				y[i] = b0 * y1 + b1 * y2 + b2 * y3 + b3 * y4;
+				z[i] = 0;
+			}
+			break;
+		}
+		case ShapeBuffer::Tag::CircleArc: {
+			const float cx = s.arcs.x[k], cy = s.arcs.y[k], rx = s.arcs.radiusX[k], ry = s.arcs.radiusY[k];
+			const float start = s.arcs.startAngle[k], sweep = s.arcs.endAngle[k];
+			for (int i = 0; i < n; i++) {
+				const float angle = start + sweep * t[i];
+				x[i] = cx + rx * std::cos(angle);
+				y[i] = cy + ry * std::sin(angle);
+				z[i] = 0;
+			}
+			break;
+		}
+	}
+}
+
+template <typename Storage>
+static void sampleUniformOf(const Storage& s, ShapeBuffer::Tag tag, uint32_t k, float start, float step, int n, float* x, float* y, float* z) {
+	switch (tag) {
+		case ShapeBuffer::Tag::Line: {
+			const float x1 = s.lines.x1[k], y1 = s.lines.y1[k], z1 = s.lines.z1[k];
+			const float dx = s.lines.x2[k] - x1, dy = s.lines.y2[k] - y1, dz = s.lines.z2[k] - z1;
+			for (int i = 0; i < n; i++) {
+				const float t = start + step * i;
+				x[i] = x1 + dx * t;
+				y[i] = y1 + dy * t;
+				z[i] = z1 + dz * t;
+			}
+			break;
+		}
+		case ShapeBuffer::Tag::CubicBezierCurve: {
+			CubicBezierCurve curve(s.curves.x1[k], s.curves.y1[k], s.curves.x2[k], s.curves.y2[k], s.curves.x3[k], s.curves.y3[k], s.curves.x4[k], s.curves.y4[k]);
+			CubicBezierCurve::Stepper(curve, start, step).generate(n, x, y, z);
+			break;
+		}
+		case ShapeBuffer::Tag::CircleArc:
+			CircleArc::sampleUniform(s.arcs.x[k], s.arcs.y[k], s.arcs.radiusX[k], s.arcs.radiusY[k], s.arcs.startAngle[k], s.arcs.endAngle[k], start, step, n, x, y, z);
+			break;
+	}
+}
+
+Frame ShapeBuffer::toFrame() const {
+	return toFrameOf(*this, tags.data(), indices.data(), size());
+}
+
+Point ShapeBuffer::nextVector(size_t index, float t) const {
+	return nextVectorOf(*this, tags[index], indices[index], t);
+}
+
+void ShapeBuffer::sampleBlock(size_t index, const float* t, int n, float* x, float* y, float* z) const {
+	sampleBlockOf(*this, tags[index], indices[index], t, n, x, y, z);
+}
+
+void ShapeBuffer::sampleUniform(size_t index, float start, float step, int n, float* x, float* y, float* z) const {
+	sampleUniformOf(*this, tags[index], indices[index], start, step, n, x, y, z);
+}
+
+Frame ShapeBufferView::toFrame() const {
+	return toFrameOf(*this, tags, indices, numShapes);
+}
+
+Point ShapeBufferView::nextVector(size_t index, float t) const {
+	return nextVectorOf(*this, tags[index], indices[index], t);
+}
+
+void ShapeBufferView::sampleBlock(size_t index, const float* t, int n, float* x, float* y, float* z) const {
+	sampleBlockOf(*this, tags[index], indices[index], t, n, x, y, z);
+}
+
+void ShapeBufferView::sampleUniform(size_t index, float start, float step, int n, float* x, float* y, float* z) const {
+	sampleUniformOf(*this, tags[index], indices[index], start, step, n, x, y, z);
+}
+
+ShapeBufferView ShapeBuffer::view() const {
+	ShapeBufferView view;
+	view.tags = tags.data();
+	view.indices = indices.data();
+	view.numShapes = size();
+	view.numLines = lines.x1.size();
+	view.numCurves = curves.x1.size();
+	view.numArcs = arcs.x.size();
+	view.lines = { lines.x1.data(), lines.y1.data(), lines.z1.data(), lines.x2.data(), lines.y2.data(), lines.z2.data() };
+	view.curves = { curves.x1.data(), curves.y1.data(), curves.x2.data(), curves.y2.data(), curves.x3.data(), curves.y3.data(), curves.x4.data(), curves.y4.data() };
+	view.arcs = { arcs.x.data(), arcs.y.data(), arcs.radiusX.data(), arcs.radiusY.data(), arcs.startAngle.data(), arcs.endAngle.data() };
+	return view;
+}
+
+float ShapeBuffer::length(size_t index) {
+	if (lengths[index] < 0) {
+		const uint32_t k = indices[index];
+		switch (tags[index]) {
+			case Tag::Line:
+				lengths[index] = Line::length(lines.x1[k], lines.y1[k], lines.z1[k], lines.x2[k], lines.y2[k], lines.z2[k]);
+				break;
+			case Tag::CubicBezierCurve:
+				lengths[index] = CubicBezierCurve::length(curves.x1[k], curves.y1[k], curves.x2[k], curves.y2[k], curves.x3[k], curves.y3[k], curves.x4[k], curves.y4[k]);
+				break;
+			case Tag::CircleArc:
+				lengths[index] = CircleArc::length(arcs.x[k], arcs.y[k], arcs.radiusX[k], arcs.radiusY[k], arcs.startAngle[k], arcs.endAngle[k]);
+				break;
+		}
+	}
+	return lengths[index];
+}
+
+float ShapeBuffer::totalLength() {
+	float length = 0.0;
+	for (size_t i = 0; i < size(); i++) {
+		length += this->length(i);
+	}
+	return length;
+}
+
+void ShapeBuffer::invalidateLengths() {
+	std::fill(lengths.begin(), lengths.end(), Shape::INVALID_LENGTH);
+}
+
+std::array<std::vector<float>*, ShapeBuffer::NUM_COORDINATE_ARRAYS> ShapeBuffer::coordinateArrays() {
+	return {
+		&lines.x1, &lines.y1, &lines.z1, &lines.x2, &lines.y2, &lines.z2,
+		&curves.x1, &curves.y1, &curves.x2, &curves.y2, &curves.x3, &curves.y3, &curves.x4, &curves.y4,
+		&arcs.x, &arcs.y, &arcs.radiusX, &arcs.radiusY, &arcs.startAngle, &arcs.endAngle,
+	};
+}
+
+std::array<const std::vector<float>*, ShapeBuffer::NUM_COORDINATE_ARRAYS> ShapeBuffer::coordinateArrays() const {
+	return {
+		&lines.x1, &lines.y1, &lines.z1, &lines.x2, &lines.y2, &lines.z2,
+		&curves.x1, &curves.y1, &curves.x2, &curves.y2, &curves.x3, &curves.y3, &curves.x4, &curves.y4,
+		&arcs.x, &arcs.y, &arcs.radiusX, &arcs.radiusY, &arcs.startAngle, &arcs.endAngle,
+	};
+}
+
+bool ShapeBuffer::hasSameLayout(const ShapeBuffer& other) const {
+	return tags == other.tags && indices == other.indices
+		&& lines.x1.size() == other.lines.x1.size()
+		&& curves.x1.size() == other.curves.x1.size()
+		&& arcs.x.size() == other.arcs.x.size();
+}
+
+static void scaleArray(std::vector<float>& values, float factor) {
+	for (auto& value : values) {
+		value *= factor;
+	}
+}
+
+static void translateArray(std::vector<float>& values, float offset) {
+	for (auto& value : values) {
+		value += offset;
+	}
+}
+
+void ShapeBuffer::scale(float x, float y, float z) {
+	scaleArray(lines.x1, x);
+	scaleArray(lines.y1, y);
+	scaleArray(lines.z1, z);
+	scaleArray(lines.x2, x);
+	scaleArray(lines.y2, y);
+	scaleArray(lines.z2, z);
+
+	scaleArray(curves.x1, x);
+	scaleArray(curves.y1, y);
+	scaleArray(curves.x2, x);
+	scaleArray(curves.y2, y);
+	scaleArray(curves.x3, x);
+	scaleArray(curves.y3, y);
+	scaleArray(curves.x4, x);
+	scaleArray(curves.y4, y);
+
+	scaleArray(arcs.x, x);
+	scaleArray(arcs.y, y);
+	scaleArray(arcs.radiusX, x);
+	scaleArray(arcs.radiusY, y);
+
+	invalidateLengths();
+}
+
+void ShapeBuffer::translate(float x, float y, float z) {
+	translateArray(lines.x1, x);
+	translateArray(lines.y1, y);
+	translateArray(lines.z1, z);
+	translateArray(lines.x2, x);
+	translateArray(lines.y2, y);
+	translateArray(lines.z2, z);
+
+	translateArray(curves.x1, x);
+	translateArray(curves.y1, y);
+	translateArray(curves.x2, x);
+	translateArray(curves.y2, y);
+	translateArray(curves.x3, x);
+	translateArray(curves.y3, y);
+	translateArray(curves.x4, x);
+	translateArray(curves.y4, y);
+
+	translateArray(arcs.x, x);
+	translateArray(arcs.y, y);
+}
+
+static void expandArray(const std::vector<float>& values, float& min, float& max) {
+	for (auto value : values) {
+		min = std::min(min, value);
+		max = std::max(max, value);
+	}
+}
+
+void ShapeBuffer::transform(const Transform3D& transform) {
+	const int numLines = (int) lines.x1.size();
+	transform.apply(lines.x1.data(), lines.y1.data(), lines.z1.data(), numLines);
+	transform.apply(lines.x2.data(), lines.y2.data(), lines.z2.data(), numLines);
+
+	const int numCurves = (int) curves.x1.size();
+	transform.applyToPlane(curves.x1.data(), curves.y1.data(), numCurves);
+	transform.applyToPlane(curves.x2.data(), curves.y2.data(), numCurves);
+	transform.applyToPlane(curves.x3.data(), curves.y3.data(), numCurves);
+	transform.applyToPlane(curves.x4.data(), curves.y4.data(), numCurves);
+
+	transform.applyToPlane(arcs.x.data(), arcs.y.data(), (int) arcs.x.size());
+
+	// On the plane the transform is a 2x2 matrix. When its columns are orthogonal it's
+	// a rotation, then a scale along each axis, and possibly a reflection in y, which
+	// reverses the angles. Arcs are axis-aligned ellipses, so the rotation can only be
+	// applied exactly to circles or in quarter turns, which swap the radii when odd.
+	const float a = transform.m[0][0], b = transform.m[0][1];
+	const float c = transform.m[1][0], d = transform.m[1][1];
+	const float halfPi = std::numbers::pi_v<float> / 2;
+	const float rotation = std::atan2(c, a);
+	const float scaleX = std::hypot(a, c);
+	const float scaleY = d * std::cos(rotation) - b * std::sin(rotation);
+	const bool orthogonal = std::abs(a * b + c * d) <= 1e-5f * (a * a + b * b + c * c + d * d);
+	const float direction = scaleY < 0 ? -1.0f : 1.0f;
+	const float quarterTurns = std::round(rotation / halfPi);
+	const bool quarterTurn = std::abs(rotation - quarterTurns * halfPi) < 1e-5f;
+	const bool swapRadii = quarterTurn && (std::abs((int) quarterTurns) % 2) == 1;
+	jassert(orthogonal);
+
+	for (size_t k = 0; k < arcs.x.size(); k++) {
+		float radiusX = arcs.radiusX[k] * scaleX;
+		float radiusY = arcs.radiusY[k] * std::abs(scaleY);
+		float offset = rotation;
+		if (quarterTurn) {
+			offset = quarterTurns * halfPi;
+			if (swapRadii) {
+				std::swap(radiusX, radiusY);
+			}
+		} else {
+			// A rotated ellipse can't be represented, so only circles rotate exactly.
+			// Radii of opposite signs, as left by normalize(), trace the circle the
+			// other way, so the rotation is subtracted from their angles.
+			jassert(std::abs(std::abs(radiusX) - std::abs(radiusY)) <= 1e-5f * std::max(std::abs(radiusX), std::abs(radiusY)));
+			if (radiusX * radiusY < 0) {
+				offset = -rotation;
+			}
+		}
+		arcs.radiusX[k] = radiusX;
+		arcs.radiusY[k] = radiusY;
+		// endAngle is the sweep from startAngle, so it only changes direction
+		arcs.startAngle[k] = direction * arcs.startAngle[k] + offset;
+		arcs.endAngle[k] = direction * arcs.endAngle[k];
+	}
+
+	invalidateLengths();
+}
+
+BoundingBox ShapeBuffer::boundingBox() const {
+	BoundingBox box;
+
+	// Line extents are their endpoints, so reduce each coordinate array directly
+	if (!lines.x1.empty()) {
+		expandArray(lines.x1, box.minX, box.maxX);
+		expandArray(lines.x2, box.minX, box.maxX);
+		expandArray(lines.y1, box.minY, box.maxY);
+		expandArray(lines.y2, box.minY, box.maxY);
+		expandArray(lines.z1, box.minZ, box.maxZ);
+		expandArray(lines.z2, box.minZ, box.maxZ);
+	}
+
+	for (size_t k = 0; k < curves.x1.size(); k++) {
+		box.expand(CubicBezierCurve::boundingBox(curves.x1[k], curves.y1[k], curves.x2[k], curves.y2[k], curves.x3[k], curves.y3[k], curves.x4[k], curves.y4[k]));
+	}
+
+	for (size_t k = 0; k < arcs.x.size(); k++) {
+		box.expand(CircleArc::boundingBox(arcs.x[k], arcs.y[k], arcs.radiusX[k], arcs.radiusY[k], arcs.startAngle[k], arcs.endAngle[k]));
+	}
+
+	return box;
+}
+
+float ShapeBuffer::width() const {
+	return boundingBox().width();
+}
+
+float ShapeBuffer::height() const {
+	return boundingBox().height();
+}
+
+Point ShapeBuffer::maxVector() const {
+	BoundingBox box = boundingBox();
+	return Point(box.maxX, box.maxY);
+}
+
+void ShapeBuffer::normalize(float width, float height) {
+	float maxDim = std::max(width, height);
+
+	scale(2.0 / maxDim, -2.0 / maxDim, 2.0 / maxDim);
+	translate(-1.0, 1.0, 0.0);
+
+	removeOutOfBounds();
+}
+
+void ShapeBuffer::normalize() {
+	BoundingBox box = boundingBox();
+	float maxDim = std::max(box.height(), box.width());
+	if (maxDim <= 0) {
+		return;
+	}
+
+	float scale = 2.0 / maxDim;
+	this->scale(scale, -scale, scale);
+	translate(-1.0, scale * (box.minY + box.maxY) / 2.0, 0.0);
+}
+
+void ShapeBuffer::addFrom(const ShapeBuffer& other, size_t index) {
+	const uint32_t k = other.indices[index];
+	switch (other.tags[index]) {
+		case Tag::Line:
+			addLine(other.lines.x1[k], other.lines.y1[k], other.lines.z1[k], other.lines.x2[k], other.lines.y2[k], other.lines.z2[k]);
+			break;
+		case Tag::CubicBezierCurve:
+			addCubicBezierCurve(other.curves.x1[k], other.curves.y1[k], other.curves.x2[k], other.curves.y2[k], other.curves.x3[k], other.curves.y3[k], other.curves.x4[k], other.curves.y4[k]);
+			break;
+		case Tag::CircleArc:
+			addCircleArc(other.arcs.x[k], other.arcs.y[k], other.arcs.radiusX[k], other.arcs.radiusY[k], other.arcs.startAngle[k], other.arcs.endAngle[k]);
+			break;
+	}
+}
+
+// Clips with the same rules as Shape::removeOutOfBounds, compacting every array
+// in one stable pass. Only curves and arcs that split into several pieces need
+// a second pass to insert the extra pieces.
+void ShapeBuffer::removeOutOfBounds() {
+	ShapeBuffer extraPieces;
+	std::vector<size_t> extraPositions;
+	Clipper::Intervals intervals;
+
+	size_t write = 0;
+	uint32_t lineWrite = 0, curveWrite = 0, arcWrite = 0;
+
+	for (size_t i = 0; i < size(); i++) {
+		const uint32_t k = indices[i];
+		uint32_t newIndex = 0;
+
+		switch (tags[i]) {
+			case Tag::Line: {
+				float t0, t1;
+				if (!Clipper::clipLine(lines.x1[k], lines.y1[k], lines.x2[k], lines.y2[k], t0, t1)) {
+					continue;
+				}
+				Line line(lines.x1[k], lines.y1[k], lines.z1[k], lines.x2[k], lines.y2[k], lines.z2[k]);
+				line.trim(t0, t1);
+
+				newIndex = lineWrite++;
+				lines.x1[newIndex] = line.x1;
+				lines.y1[newIndex] = line.y1;
+				lines.z1[newIndex] = line.z1;
+				lines.x2[newIndex] = line.x2;
+				lines.y2[newIndex] = line.y2;
+				lines.z2[newIndex] = line.z2;
+				break;
+			}
+			case Tag::CubicBezierCurve: {
+				CubicBezierCurve curve(curves.x1[k], curves.y1[k], curves.x2[k], curves.y2[k], curves.x3[k], curves.y3[k], curves.x4[k], curves.y4[k]);
+				Clipper::clipCubicBezierCurve(curve.x1, curve.y1, curve.x2, curve.y2, curve.x3, curve.y3, curve.x4, curve.y4, intervals);
+				if (intervals.count == 0) {
+					continue;
+				}
+				for (int j = 1; j < intervals.count; j++) {
+					CubicBezierCurve piece = curve;
+					piece.trim(intervals.start[j], intervals.end[j]);
+					extraPieces.addCubicBezierCurve(piece.x1, piece.y1, piece.x2, piece.y2, piece.x3, piece.y3, piece.x4, piece.y4);
+					extraPositions.push_back(write);
+				}
+				curve.trim(intervals.start[0], intervals.end[0]);
+
+				newIndex = curveWrite++;
+				curves.x1[newIndex] = curve.x1;
+				curves.y1[newIndex] = curve.y1;
+				curves.x2[newIndex] = curve.x2;
+				curves.y2[newIndex] = curve.y2;
+				curves.x3[newIndex] = curve.x3;
+				curves.y3[newIndex] = curve.y3;
+				curves.x4[newIndex] = curve.x4;
+				curves.y4[newIndex] = curve.y4;
+				break;
+			}
+			case Tag::CircleArc: {
+				CircleArc arc(arcs.x[k], arcs.y[k], arcs.radiusX[k], arcs.radiusY[k], arcs.startAngle[k], arcs.endAngle[k]);
+				Clipper::clipCircleArc(arc.x, arc.y, arc.radiusX, arc.radiusY, arc.startAngle, arc.endAngle, intervals);
+				if (intervals.count == 0) {
+					continue;
+				}
+				for (int j = 1; j < intervals.count; j++) {
+					CircleArc piece = arc;
+					piece.trim(intervals.start[j], intervals.end[j]);
+					extraPieces.addCircleArc(piece.x, piece.y, piece.radiusX, piece.radiusY, piece.startAngle, piece.endAngle);
+					extraPositions.push_back(write);
+				}
+				arc.trim(intervals.start[0], intervals.end[0]);
+
+				newIndex = arcWrite++;
+				arcs.x[newIndex] = arc.x;
+				arcs.y[newIndex] = arc.y;
+				arcs.radiusX[newIndex] = arc.radiusX;
+				arcs.radiusY[newIndex] = arc.radiusY;
+				arcs.startAngle[newIndex] = arc.startAngle;
+				arcs.endAngle[newIndex] = arc.endAngle;
+				break;
+			}
+		}
+
+		tags[write] = tags[i];
+		indices[write] = newIndex;
+		lengths[write] = Shape::INVALID_LENGTH;
+		write++;
+	}
+
+	tags.resize(write);
+	indices.resize(write);
+	lengths.resize(write);
+
+	for (auto* values : { &lines.x1, &lines.y1, &lines.z1, &lines.x2, &lines.y2, &lines.z2 }) {
+		values->resize(lineWrite);
+	}
+	for (auto* values : { &curves.x1, &curves.y1, &curves.x2, &curves.y2, &curves.x3, &curves.y3, &curves.x4, &curves.y4 }) {
+		values->resize(curveWrite);
+	}
+	for (auto* values : { &arcs.x, &arcs.y, &arcs.radiusX, &arcs.radiusY, &arcs.startAngle, &arcs.endAngle }) {
+		values->resize(arcWrite);
+	}
+
+	if (extraPieces.empty()) {
+		return;
+	}
+
+	ShapeBuffer merged;
+	merged.reserve(size() + extraPieces.size());
+	size_t next = 0;
+	for (size_t i = 0; i < size(); i++) {
+		merged.addFrom(*this, i);
+		while (next < extraPositions.size() && extraPositions[next] == i) {
+			merged.addFrom(extraPieces, next++);
+		}
+	}
+	*this = std::move(merged);
+}
+
+} // namespace osci
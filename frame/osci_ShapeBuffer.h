@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "osci_Frame.h"
+#include "../shape/osci_Point.h"
+#include "../shape/osci_Transform3D.h"
+
+namespace osci {
+
+struct ShapeBufferView;
+
+// Contiguous structure-of-arrays alternative to Frame. Each shape is a tag plus an
+// index into the parallel coordinate arrays for its kind, so bulk operations are
+// flat loops over floats rather than virtual calls on individually allocated shapes.
+class ShapeBuffer {
+public:
+	enum class Tag : uint8_t {
+		Line,
+		CubicBezierCurve,
+		CircleArc,
+	};
+
+	ShapeBuffer() = default;
+	explicit ShapeBuffer(const Frame& frame);
+
+	void clear();
+	void reserve(size_t numShapes);
+	size_t size() const { return tags.size(); }
+	bool empty() const { return tags.empty(); }
+
+	void addLine(float x1, float y1, float z1, float x2, float y2, float z2);
+	void addCubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
+	void addCircleArc(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle);
+	// Shapes other than lines, curves and arcs are approximated by lines between samples.
+	void add(Shape& shape);
+
+	void assign(const Frame& frame);
+	// Copies the arrays of a view in bulk, without any per-shape work.
+	void assign(const ShapeBufferView& view);
+	Frame toFrame() const;
+	ShapeBufferView view() const;
+
+	Tag tag(size_t index) const { return tags[index]; }
+	// Index of the shape within the coordinate arrays for its tag.
+	uint32_t kindIndex(size_t index) const { return indices[index]; }
+
+	Point nextVector(size_t index, float drawingProgress) const;
+	void sampleBlock(size_t index, const float* drawingProgress, int n, float* x, float* y, float* z) const;
+	void sampleUniform(size_t index, float start, float step, int n, float* x, float* y, float* z) const;
+	float length(size_t index);
+	float totalLength();
+
+	void scale(float x, float y, float z);
+	void translate(float x, float y, float z);
+	// Lines are transformed exactly. Curves are 2D, so their control points are
+	// transformed from the z = 0 plane and the resulting z is dropped. Arcs are
+	// transformed on the plane too, exactly for scales, reflections and rotations of
+	// circles or by quarter turns. Other transforms of arcs, such as shears or
+	// rotations of ellipses, can't be represented and assert.
+	void transform(const Transform3D& transform);
+	BoundingBox boundingBox() const;
+	float width() const;
+	float height() const;
+	Point maxVector() const;
+	void normalize(float width, float height);
+	void normalize();
+	void removeOutOfBounds();
+
+	struct Lines {
+		std::vector<float> x1, y1, z1, x2, y2, z2;
+	} lines;
+
+	struct CubicBezierCurves {
+		std::vector<float> x1, y1, x2, y2, x3, y3, x4, y4;
+	} curves;
+
+	struct CircleArcs {
+		std::vector<float> x, y, radiusX, radiusY, startAngle, endAngle;
+	} arcs;
+
+	// Every coordinate array above, lines then curves then arcs, for code that
+	// treats them uniformly. Call invalidateLengths() after changing them directly.
+	static constexpr int NUM_COORDINATE_ARRAYS = 20;
+	// Positions within coordinateArrays()
+	static constexpr int LINE_Z1_ARRAY = 2;
+	static constexpr int LINE_Z2_ARRAY = 5;
+	static constexpr int FIRST_CURVE_ARRAY = 6;
+	static constexpr int FIRST_ARC_ARRAY = 14;
+	static constexpr int ARC_START_ANGLE_ARRAY = 18;
+	static constexpr int ARC_END_ANGLE_ARRAY = 19;
+	// Every array before the arc angles holds positions or radii, which are bounded
+	// by the frame's extent and so can be quantised to it. Angles aren't, and an
+	// error in one grows with the radius, so they're always kept as floats.
+	static constexpr int NUM_QUANTISABLE_ARRAYS = ARC_START_ANGLE_ARRAY;
+	static constexpr bool isQuantisable(int array) { return array < NUM_QUANTISABLE_ARRAYS; }
+	std::array<std::vector<float>*, NUM_COORDINATE_ARRAYS> coordinateArrays();
+	std::array<const std::vector<float>*, NUM_COORDINATE_ARRAYS> coordinateArrays() const;
+	void invalidateLengths();
+
+	// True when both buffers hold the same kinds of shape in the same order, so
+	// their coordinate arrays correspond element for element.
+	bool hasSameLayout(const ShapeBuffer& other) const;
+
+private:
+	void push(Tag tag, size_t kindSize);
+	void addFrom(const ShapeBuffer& other, size_t index);
+
+	std::vector<Tag> tags;
+	std::vector<uint32_t> indices;
+	// Cached per-shape lengths, negative when not yet computed.
+	std::vector<float> lengths;
+
+	friend class FrameFile;
+	friend class QuantisedFrame;
+};
+
+// Non-owning view of shapes laid out as in a ShapeBuffer, e.g. in a memory-mapped
+// FrameFile, that can be sampled without first copying it into a ShapeBuffer.
+struct ShapeBufferView {
+	const ShapeBuffer::Tag* tags = nullptr;
+	const uint32_t* indices = nullptr;
+	size_t numShapes = 0;
+	size_t numLines = 0;
+	size_t numCurves = 0;
+	size_t numArcs = 0;
+
+	struct Lines {
+		const float *x1, *y1, *z1, *x2, *y2, *z2;
+	} lines{};
+
+	struct CubicBezierCurves {
+		const float *x1, *y1, *x2, *y2, *x3, *y3, *x4, *y4;
+	} curves{};
+
+	struct CircleArcs {
+		const float *x, *y, *radiusX, *radiusY, *startAngle, *endAngle;
+	} arcs{};
+
+	size_t size() const { return numShapes; }
+	bool empty() const { return numShapes == 0; }
+	ShapeBuffer::Tag tag(size_t index) const { return tags[index]; }
+	uint32_t kindIndex(size_t index) const { return indices[index]; }
+
+	Point nextVector(size_t index, float drawingProgress) const;
+	void sampleBlock(size_t index, const float* drawingProgress, int n, float* x, float* y, float* z) const;
+	void sampleUniform(size_t index, float start, float step, int n, float* x, float* y, float* z) const;
+	Frame toFrame() const;
+};
+
+} // namespace osci
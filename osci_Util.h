@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <numbers>
 
 namespace osci {
@@ -13,6 +15,37 @@ public:
         constexpr double pi = std::numbers::pi;
         return std::fmod(std::fmod(angle + pi, twoPi) + twoPi, twoPi) - pi;
     }
+
+    // 5-point Gauss-Legendre quadrature of f over [a, b]. Exact for polynomials
+    // up to degree 9, so a handful of intervals is enough for smooth integrands.
+    template <typename F>
+    static inline float integrate(F f, float a, float b) {
+        constexpr float nodes[5] = { 0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f };
+        constexpr float weights[5] = { 0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f };
+        const float halfWidth = 0.5f * (b - a);
+        const float mid = 0.5f * (a + b);
+        float sum = 0.0f;
+        for (int i = 0; i < 5; i++) {
+            sum += weights[i] * f(mid + halfWidth * nodes[i]);
+        }
+        return sum * halfWidth;
+    }
+
+    // Stores values in [-range, range] as 16-bit integers, clamping anything outside.
+    static inline void quantise(const float* values, int16_t* quantised, size_t n, float range) {
+        const float scale = range > 0 ? 32767.0f / range : 0.0f;
+        for (size_t i = 0; i < n; i++) {
+            const float scaled = std::fmin(std::fmax(values[i] * scale, -32767.0f), 32767.0f);
+            quantised[i] = (int16_t) std::lrint(scaled);
+        }
+    }
+
+    static inline void dequantise(const int16_t* quantised, float* values, size_t n, float range) {
+        const float scale = range / 32767.0f;
+        for (size_t i = 0; i < n; i++) {
+            values[i] = quantised[i] * scale;
+        }
+    }
 };
 
 } // namespace osci
@@ -33,6 +33,7 @@
 // Include effect implementations
 #include "effect/osci_Effect.cpp"
 #include "effect/osci_EffectApplication.cpp"
+#include "effect/osci_EffectChain.cpp"
 
 // Include shape implementations
 #include "shape/osci_Shape.cpp"
@@ -41,6 +42,22 @@
 #include "shape/osci_CircleArc.cpp"
 #include "shape/osci_CubicBezierCurve.cpp"
 #include "shape/osci_QuadraticBezierCurve.cpp"
+#include "shape/osci_Clipper.cpp"
+#include "shape/osci_Transform3D.cpp"
+
+// Include frame implementations
+#include "frame/osci_Frame.cpp"
+#include "frame/osci_FrameArena.cpp"
+#include "frame/osci_FrameBvh.cpp"
+#include "frame/osci_FrameCompiler.cpp"
+#include "frame/osci_FrameFile.cpp"
+#include "frame/osci_FrameIndex.cpp"
+#include "frame/osci_FrameLod.cpp"
+#include "frame/osci_FrameMorpher.cpp"
+#include "frame/osci_FramePathOptimiser.cpp"
+#include "frame/osci_FrameSequence.cpp"
+#include "frame/osci_QuantisedFrame.cpp"
+#include "frame/osci_ShapeBuffer.cpp"
 
 // Include midi implementations
 #include "midi/osci_MidiCCManager.cpp"
@@ -48,6 +65,7 @@
 // Include concurrency implementations
 #include "concurrency/osci_AudioBackgroundThread.cpp"
 #include "concurrency/osci_AudioBackgroundThreadManager.cpp"
+#include "concurrency/osci_FrameProducerPool.cpp"
 
 // Include DSP implementations
 #include "dsp/osci_IntegerRatioSampleRateAdapter.cpp"
@@ -62,16 +62,35 @@
 #include "effect/osci_Effect.h"
 #include "effect/osci_SimpleEffect.h"
 #include "effect/osci_EffectApplication.h"
+#include "effect/osci_EffectChain.h"
 #include "effect/osci_EffectParameter.h"
 #include "effect/osci_SimpleEffect.h"
 
 // Include shape headers
 #include "shape/osci_CircleArc.h"
+#include "shape/osci_Clipper.h"
 #include "shape/osci_CubicBezierCurve.h"
 #include "shape/osci_Line.h"
 #include "shape/osci_Point.h"
+#include "shape/osci_PointSample.h"
 #include "shape/osci_QuadraticBezierCurve.h"
 #include "shape/osci_Shape.h"
+#include "shape/osci_Transform3D.h"
+
+// Include frame headers
+#include "frame/osci_Frame.h"
+#include "frame/osci_LruCache.h"
+#include "frame/osci_FrameArena.h"
+#include "frame/osci_FrameBvh.h"
+#include "frame/osci_FrameCompiler.h"
+#include "frame/osci_FrameFile.h"
+#include "frame/osci_FrameIndex.h"
+#include "frame/osci_FrameLod.h"
+#include "frame/osci_FrameMorpher.h"
+#include "frame/osci_FramePathOptimiser.h"
+#include "frame/osci_FrameSequence.h"
+#include "frame/osci_QuantisedFrame.h"
+#include "frame/osci_ShapeBuffer.h"
 
 // Include midi headers
 #include "midi/osci_MidiCCManager.h"
@@ -84,6 +103,7 @@
 #include "concurrency/osci_AudioBackgroundThreadManager.h"
 #include "concurrency/osci_BlockingQueue.h"
 #include "concurrency/osci_BufferConsumer.h"
+#include "concurrency/osci_FrameProducerPool.h"
 #include "concurrency/osci_WriteProcess.h"
 
 // Include DSP headers
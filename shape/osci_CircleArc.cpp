@@ -1,6 +1,6 @@
 #include "osci_CircleArc.h"
 #include <numbers>
-#include "osci_Line.h"
+#include "../osci_Util.h"
 
 namespace osci {
 
@@ -15,6 +15,46 @@ Point CircleArc::nextVector(float drawingProgress) {
 	);
 }
 
+void CircleArc::sampleBlock(const float* t, int n, float* x, float* y, float* z) {
+	for (int i = 0; i < n; i++) {
+		const float angle = startAngle + endAngle * t[i];
+		x[i] = this->x + radiusX * std::cos(angle);
+		y[i] = this->y + radiusY * std::sin(angle);
+		z[i] = 0;
+	}
+}
+
+void CircleArc::sampleUniform(float start, float step, int n, float* x, float* y, float* z) {
+	sampleUniform(this->x, this->y, radiusX, radiusY, startAngle, endAngle, start, step, n, x, y, z);
+}
+
+// Rotates a unit vector by a fixed angle each sample, so a block costs one sincos
+// per resync interval plus a complex multiply per sample. Resyncing from the exact
+// angle bounds the drift in magnitude and phase from float rounding.
+void CircleArc::sampleUniform(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle, float start, float step, int n, float* xs, float* ys, float* zs) {
+	constexpr int resyncInterval = 64;
+
+	const double angleStart = startAngle + (double) endAngle * start;
+	const double angleStep = (double) endAngle * step;
+	const float stepCos = std::cos(angleStep);
+	const float stepSin = std::sin(angleStep);
+
+	for (int i = 0; i < n; i += resyncInterval) {
+		const int end = std::min(n, i + resyncInterval);
+		const double angle = angleStart + angleStep * i;
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		for (int j = i; j < end; j++) {
+			xs[j] = x + radiusX * c;
+			ys[j] = y + radiusY * s;
+			zs[j] = 0;
+			const float nextC = c * stepCos - s * stepSin;
+			s = s * stepCos + c * stepSin;
+			c = nextC;
+		}
+	}
+}
+
 void CircleArc::scale(float x, float y, float z) {
 	this->x *= x;
 	this->y *= y;
@@ -27,22 +67,97 @@ void CircleArc::translate(float x, float y, float z) {
 	this->y += y;
 }
 
+void CircleArc::trim(float t0, float t1) {
+	startAngle += endAngle * t0;
+	endAngle *= t1 - t0;
+	len = INVALID_LENGTH;
+}
+
+void CircleArc::reverse() {
+	startAngle += endAngle;
+	endAngle = -endAngle;
+}
+
+float CircleArc::length(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle) {
+	constexpr float pi = std::numbers::pi;
+	constexpr float twoPi = 2 * std::numbers::pi;
+
+	const float a = std::abs(radiusX);
+	const float b = std::abs(radiusY);
+	const float sweep = std::abs(endAngle);
+
+	if (std::abs(a - b) <= 1e-6f * std::max(a, b)) {
+		return 0.5f * (a + b) * sweep;
+	}
+
+	// Whole turns use Ramanujan's second approximation of the ellipse perimeter
+	const float turns = std::floor(sweep / twoPi);
+	float length = 0;
+	if (turns > 0) {
+		const float h = (a - b) * (a - b) / ((a + b) * (a + b));
+		length += turns * pi * (a + b) * (1 + 3 * h / (10 + std::sqrt(4 - 3 * h)));
+	}
+
+	// The remaining partial arc is integrated directly, in eighth-turn pieces so
+	// quadrature stays accurate for eccentric ellipses where the speed varies sharply.
+	const float remaining = sweep - turns * twoPi;
+	if (remaining > 0) {
+		const float direction = endAngle < 0 ? -1.0f : 1.0f;
+		const float from = startAngle + direction * turns * twoPi;
+		auto speed = [a, b](float angle) {
+			const float s = std::sin(angle);
+			const float c = std::cos(angle);
+			return std::sqrt(a * a * s * s + b * b * c * c);
+		};
+		const int pieces = std::max(1, (int) std::ceil(remaining / (0.25f * pi)));
+		const float pieceSweep = remaining / pieces;
+		for (int i = 0; i < pieces; i++) {
+			const float pieceStart = from + direction * pieceSweep * i;
+			length += std::abs(Util::integrate(speed, pieceStart, pieceStart + direction * pieceSweep));
+		}
+	}
+
+	return length;
+}
+
 float CircleArc::length() {
 	if (len < 0) {
-		len = 0;
-        // TODO: Replace this, it's stupid. Do a real approximation.
-        int segments = 5;
-		Point start;
-		Point end = nextVector(0);
-		for (int i = 0; i < segments; i++) {
-			start = end;
-			end = nextVector((i + 1) / (float) segments);
-			len += Line::length(start.x, start.y, start.z, end.x, end.y, end.z);
-		}
+		len = length(x, y, radiusX, radiusY, startAngle, endAngle);
 	}
 	return len;
 }
 
+BoundingBox CircleArc::boundingBox(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle) {
+	constexpr double halfPi = std::numbers::pi / 2;
+
+	BoundingBox box;
+	auto expand = [&](double angle) {
+		box.expand(x + radiusX * std::cos(angle), y + radiusY * std::sin(angle), 0);
+	};
+
+	const double from = std::min(startAngle, startAngle + endAngle);
+	const double to = std::max(startAngle, startAngle + endAngle);
+	expand(from);
+	expand(to);
+
+	// Extremes in x and y lie at multiples of a quarter turn
+	if (to - from >= 4 * halfPi) {
+		for (int i = 0; i < 4; i++) {
+			expand(i * halfPi);
+		}
+	} else {
+		for (double k = std::ceil(from / halfPi); k * halfPi <= to; k++) {
+			expand(k * halfPi);
+		}
+	}
+
+	return box;
+}
+
+BoundingBox CircleArc::boundingBox() {
+	return boundingBox(x, y, radiusX, radiusY, startAngle, endAngle);
+}
+
 std::unique_ptr<Shape> CircleArc::clone() {
 	return std::make_unique<CircleArc>(x, y, radiusX, radiusY, startAngle, endAngle);
 }
@@ -9,9 +9,19 @@ public:
 	CircleArc(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle);
 
 	Point nextVector(float drawingProgress) override;
+	void sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z) override;
+	void sampleUniform(float start, float step, int n, float* x, float* y, float* z) override;
+	static void sampleUniform(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle, float start, float step, int n, float* xs, float* ys, float* zs);
 	void scale(float x, float y, float z) override;
 	void translate(float x, float y, float z) override;
+	// Restricts the arc to the part drawn between progress t0 and t1.
+	void trim(float t0, float t1);
+	// Starts at the other end of the arc and sweeps back the other way.
+	void reverse();
+	static float length(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle);
 	float length() override;
+	static BoundingBox boundingBox(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle);
+	BoundingBox boundingBox() override;
 	std::unique_ptr<Shape> clone() override;
 	std::string type() override;
 
@@ -0,0 +1,205 @@
+#include "osci_Clipper.h"
+#include "osci_Line.h"
+#include "osci_CubicBezierCurve.h"
+#include "osci_CircleArc.h"
+
+namespace osci {
+
+// Subdivision depth at which a piece straddling the edge is classified by its
+// midpoint, i.e. the clipped ends are accurate to 1 / 2^12 of the parameter.
+static constexpr int MAX_CLIP_DEPTH = 12;
+
+static bool boxInside(const BoundingBox& box) {
+	return box.minX >= -1 && box.maxX <= 1 && box.minY >= -1 && box.maxY <= 1;
+}
+
+static bool boxOutside(const BoundingBox& box) {
+	return box.maxX < -1 || box.minX > 1 || box.maxY < -1 || box.minY > 1;
+}
+
+static bool pointInside(const Point& point) {
+	return point.x >= -1 && point.x <= 1 && point.y >= -1 && point.y <= 1;
+}
+
+static void addInterval(Clipper::Intervals& intervals, float start, float end) {
+	if (intervals.count > 0 && intervals.end[intervals.count - 1] == start) {
+		intervals.end[intervals.count - 1] = end;
+	} else if (intervals.count == Clipper::MAX_INTERVALS) {
+		// Out of room, so keep the gap rather than lose the piece
+		intervals.end[intervals.count - 1] = end;
+	} else {
+		intervals.start[intervals.count] = start;
+		intervals.end[intervals.count] = end;
+		intervals.count++;
+	}
+}
+
+// Recursively halves [t0, t1] until each piece's bounds are entirely inside or
+// outside the square. bounds(t0, t1) must contain the shape over that range.
+template <typename Bounds, typename Evaluate>
+static void subdivide(Bounds& bounds, Evaluate& evaluate, float t0, float t1, int depth, Clipper::Intervals& intervals) {
+	BoundingBox box = bounds(t0, t1);
+	if (boxOutside(box)) {
+		return;
+	}
+	if (boxInside(box)) {
+		addInterval(intervals, t0, t1);
+		return;
+	}
+
+	const float mid = 0.5f * (t0 + t1);
+	if (depth >= MAX_CLIP_DEPTH) {
+		if (pointInside(evaluate(mid))) {
+			addInterval(intervals, t0, t1);
+		}
+		return;
+	}
+
+	subdivide(bounds, evaluate, t0, mid, depth + 1, intervals);
+	subdivide(bounds, evaluate, mid, t1, depth + 1, intervals);
+}
+
+bool Clipper::clipLine(float x1, float y1, float x2, float y2, float& t0, float& t1) {
+	const float dx = x2 - x1;
+	const float dy = y2 - y1;
+	const float p[4] = { -dx, dx, -dy, dy };
+	const float q[4] = { x1 + 1, 1 - x1, y1 + 1, 1 - y1 };
+
+	t0 = 0;
+	t1 = 1;
+	for (int i = 0; i < 4; i++) {
+		if (p[i] == 0) {
+			if (q[i] < 0) {
+				return false;
+			}
+		} else {
+			const float t = q[i] / p[i];
+			if (p[i] < 0) {
+				t0 = std::max(t0, t);
+			} else {
+				t1 = std::min(t1, t);
+			}
+		}
+	}
+
+	return t0 <= t1;
+}
+
+void Clipper::clipCubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, Intervals& intervals) {
+	CubicBezierCurve curve(x1, y1, x2, y2, x3, y3, x4, y4);
+
+	// The control points of a section bound it, by the convex hull property
+	auto bounds = [&curve](float t0, float t1) {
+		CubicBezierCurve section = curve;
+		section.trim(t0, t1);
+		BoundingBox box;
+		box.expand(section.x1, section.y1, 0);
+		box.expand(section.x2, section.y2, 0);
+		box.expand(section.x3, section.y3, 0);
+		box.expand(section.x4, section.y4, 0);
+		return box;
+	};
+	auto evaluate = [&curve](float t) { return curve.nextVector(t); };
+
+	intervals.count = 0;
+	subdivide(bounds, evaluate, 0.0f, 1.0f, 0, intervals);
+}
+
+void Clipper::clipCircleArc(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle, Intervals& intervals) {
+	CircleArc arc(x, y, radiusX, radiusY, startAngle, endAngle);
+
+	auto bounds = [&](float t0, float t1) {
+		return CircleArc::boundingBox(x, y, radiusX, radiusY, startAngle + endAngle * t0, endAngle * (t1 - t0));
+	};
+	auto evaluate = [&arc](float t) { return arc.nextVector(t); };
+
+	intervals.count = 0;
+	subdivide(bounds, evaluate, 0.0f, 1.0f, 0, intervals);
+}
+
+// Fills intervals for shape and returns false if it can't be trimmed, in which
+// case intervals only says whether any of it is inside.
+static bool clipShape(Shape& shape, Clipper::Intervals& intervals) {
+	intervals.count = 0;
+
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		float t0, t1;
+		if (Clipper::clipLine(line->x1, line->y1, line->x2, line->y2, t0, t1)) {
+			addInterval(intervals, t0, t1);
+		}
+		return true;
+	} else if (auto curve = dynamic_cast<CubicBezierCurve*>(&shape)) {
+		Clipper::clipCubicBezierCurve(curve->x1, curve->y1, curve->x2, curve->y2, curve->x3, curve->y3, curve->x4, curve->y4, intervals);
+		return true;
+	} else if (auto arc = dynamic_cast<CircleArc*>(&shape)) {
+		Clipper::clipCircleArc(arc->x, arc->y, arc->radiusX, arc->radiusY, arc->startAngle, arc->endAngle, intervals);
+		return true;
+	}
+
+	if (!boxOutside(shape.boundingBox())) {
+		addInterval(intervals, 0, 1);
+	}
+	return false;
+}
+
+static void trimShape(Shape& shape, float t0, float t1) {
+	if (t0 <= 0 && t1 >= 1) {
+		return;
+	}
+	if (auto line = dynamic_cast<Line*>(&shape)) {
+		line->trim(t0, t1);
+	} else if (auto curve = dynamic_cast<CubicBezierCurve*>(&shape)) {
+		curve->trim(t0, t1);
+	} else if (auto arc = dynamic_cast<CircleArc*>(&shape)) {
+		arc->trim(t0, t1);
+	}
+}
+
+void Clipper::clip(std::vector<std::unique_ptr<Shape>>& shapes) {
+	// Extra pieces of split shapes, each to be inserted after the given output index
+	std::vector<std::pair<size_t, std::unique_ptr<Shape>>> extraPieces;
+	Intervals intervals;
+	size_t write = 0;
+
+	for (size_t read = 0; read < shapes.size(); read++) {
+		Shape& shape = *shapes[read];
+		const bool trimmable = clipShape(shape, intervals);
+		if (intervals.count == 0) {
+			continue;
+		}
+
+		if (trimmable) {
+			for (int i = 1; i < intervals.count; i++) {
+				auto piece = shape.clone();
+				trimShape(*piece, intervals.start[i], intervals.end[i]);
+				extraPieces.emplace_back(write, std::move(piece));
+			}
+			trimShape(shape, intervals.start[0], intervals.end[0]);
+		}
+
+		if (write != read) {
+			shapes[write] = std::move(shapes[read]);
+		}
+		write++;
+	}
+
+	shapes.resize(write);
+
+	if (extraPieces.empty()) {
+		return;
+	}
+
+	std::vector<std::unique_ptr<Shape>> merged;
+	merged.reserve(shapes.size() + extraPieces.size());
+	size_t next = 0;
+	for (size_t i = 0; i < shapes.size(); i++) {
+		merged.push_back(std::move(shapes[i]));
+		while (next < extraPieces.size() && extraPieces[next].first == i) {
+			merged.push_back(std::move(extraPieces[next].second));
+			next++;
+		}
+	}
+	shapes = std::move(merged);
+}
+
+} // namespace osci
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "osci_Shape.h"
+
+namespace osci {
+
+// Clips shapes to the [-1, 1] square that Shape::normalize maps frames into.
+class Clipper {
+public:
+	static constexpr int MAX_INTERVALS = 8;
+
+	// Ranges of drawing progress that lie inside the square, in drawing order.
+	struct Intervals {
+		int count = 0;
+		float start[MAX_INTERVALS];
+		float end[MAX_INTERVALS];
+	};
+
+	// Liang-Barsky clipping. Returns false when the line misses the square.
+	static bool clipLine(float x1, float y1, float x2, float y2, float& t0, float& t1);
+	static void clipCubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, Intervals& intervals);
+	static void clipCircleArc(float x, float y, float radiusX, float radiusY, float startAngle, float endAngle, Intervals& intervals);
+
+	// Clips every shape in place and drops those entirely outside the square,
+	// keeping the remaining shapes in order. Only curves that leave and re-enter
+	// the square, and so split into several pieces, cause an allocation.
+	static void clip(std::vector<std::unique_ptr<Shape>>& shapes);
+};
+
+} // namespace osci
@@ -1,19 +1,132 @@
 #include "osci_CubicBezierCurve.h"
+#include "../osci_Util.h"
 
 namespace osci {
 
 CubicBezierCurve::CubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) : x1(x1), y1(y1), x2(x2), y2(y2), x3(x3), y3(y3), x4(x4), y4(y4) {}
 
-Point CubicBezierCurve::nextVector(float t) {
-	float pow1 = pow(1 - t, 3);
-	float pow2 = pow(1 - t, 2);
-	float pow3 = pow(t, 2);
-	float pow4 = pow(t, 3);
+Point CubicBezierCurve::evaluate(float t) const {
+	const float u = 1 - t;
+	const float b0 = u * u * u;
+	const float b1 = 3 * u * u * t;
+	const float b2 = 3 * u * t * t;
+	const float b3 = t * t * t;
 
-	float x = pow1 * x1 + 3 * pow2 * t * x2 + 3 * (1 - t) * pow3 * x3 + pow4 * x4;
-	float y = pow1 * y1 + 3 * pow2 * t * y2 + 3 * (1 - t) * pow3 * y3 + pow4 * y4;
-	
-	return Point(x, y);
+	return Point(
+		b0 * x1 + b1 * x2 + b2 * x3 + b3 * x4,
+		b0 * y1 + b1 * y2 + b2 * y3 + b3 * y4
+	);
+}
+
+// Magnitude of the first derivative, i.e. the rate of change of arc length with t.
+float CubicBezierCurve::speed(float t) const {
+	const float u = 1 - t;
+	const float a = 3 * u * u;
+	const float b = 6 * u * t;
+	const float c = 3 * t * t;
+	const float dx = a * (x2 - x1) + b * (x3 - x2) + c * (x4 - x3);
+	const float dy = a * (y2 - y1) + b * (y3 - y2) + c * (y4 - y3);
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+Point CubicBezierCurve::nextVector(float drawingProgress) {
+	return evaluate(arcLengthParameterised ? parameterAtProgress(drawingProgress) : drawingProgress);
+}
+
+void CubicBezierCurve::sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z) {
+	if (arcLengthParameterised) {
+		for (int i = 0; i < n; i++) {
+			Point point = evaluate(parameterAtProgress(drawingProgress[i]));
+			x[i] = point.x;
+			y[i] = point.y;
+			z[i] = 0;
+		}
+		return;
+	}
+
+	for (int i = 0; i < n; i++) {
+		const float t = drawingProgress[i];
+		const float u = 1 - t;
+		const float b0 = u * u * u;
+		const float b1 = 3 * u * u * t;
+		const float b2 = 3 * u * t * t;
+		const float b3 = t * t * t;
+		x[i] = b0 * x1 + b1 * x2 + b2 * x3 + b3 * x4;
+		y[i] = b0 * y1 + b1 * y2 + b2 * y3 + b3 * y4;
+		z[i] = 0;
+	}
+}
+
+void CubicBezierCurve::sampleUniform(float start, float step, int n, float* x, float* y, float* z) {
+	// Forward differencing only holds for uniform steps in t, not arc length
+	if (arcLengthParameterised) {
+		Shape::sampleUniform(start, step, n, x, y, z);
+		return;
+	}
+	Stepper(*this, start, step).generate(n, x, y, z);
+}
+
+CubicBezierCurve::Stepper::Stepper(const CubicBezierCurve& curve, float start, float step) : start(start), step(step) {
+	xAxis.set(curve.x1, curve.x2, curve.x3, curve.x4);
+	yAxis.set(curve.y1, curve.y2, curve.y3, curve.y4);
+}
+
+void CubicBezierCurve::Stepper::Axis::set(float p1, float p2, float p3, float p4) {
+	a = -p1 + 3 * p2 - 3 * p3 + p4;
+	b = 3 * p1 - 6 * p2 + 3 * p3;
+	c = -3 * p1 + 3 * p2;
+	d = p1;
+}
+
+void CubicBezierCurve::Stepper::Axis::resync(float t, float h) {
+	const float h2 = h * h;
+	const float h3 = h2 * h;
+	value = ((a * t + b) * t + c) * t + d;
+	delta1 = a * (3 * t * t * h + 3 * t * h2 + h3) + b * (2 * t * h + h2) + c * h;
+	delta2 = 6 * a * t * h2 + 6 * a * h3 + 2 * b * h2;
+	delta3 = 6 * a * h3;
+}
+
+float CubicBezierCurve::Stepper::Axis::step() {
+	const float current = value;
+	value += delta1;
+	delta1 += delta2;
+	delta2 += delta3;
+	return current;
+}
+
+void CubicBezierCurve::Stepper::resync() {
+	const float t = start + step * index;
+	xAxis.resync(t, step);
+	yAxis.resync(t, step);
+	untilResync = RESYNC_INTERVAL;
+}
+
+Point CubicBezierCurve::Stepper::next() {
+	if (untilResync == 0) {
+		resync();
+	}
+	untilResync--;
+	index++;
+	const float x = xAxis.step();
+	return Point(x, yAxis.step());
+}
+
+void CubicBezierCurve::Stepper::generate(int n, float* x, float* y, float* z) {
+	int i = 0;
+	while (i < n) {
+		if (untilResync == 0) {
+			resync();
+		}
+		const int end = std::min(n, i + untilResync);
+		untilResync -= end - i;
+		index += end - i;
+		for (; i < end; i++) {
+			x[i] = xAxis.step();
+			y[i] = yAxis.step();
+			z[i] = 0;
+		}
+	}
 }
 
 void CubicBezierCurve::scale(float x, float y, float z) {
@@ -25,6 +138,9 @@ void CubicBezierCurve::scale(float x, float y, float z) {
 	y3 *= y;
 	x4 *= x;
 	y4 *= y;
+
+	len = INVALID_LENGTH;
+	arcLengthTableValid = false;
 }
 
 void CubicBezierCurve::translate(float x, float y, float z) {
@@ -38,19 +154,170 @@ void CubicBezierCurve::translate(float x, float y, float z) {
 	y4 += y;
 }
 
+void CubicBezierCurve::buildArcLengthTable() {
+	auto speedAt = [this](float t) { return speed(t); };
+
+	arcLengthTable[0] = 0;
+	for (int i = 0; i < ARC_LENGTH_SEGMENTS; i++) {
+		const float a = i / (float) ARC_LENGTH_SEGMENTS;
+		const float b = (i + 1) / (float) ARC_LENGTH_SEGMENTS;
+		arcLengthTable[i + 1] = arcLengthTable[i] + Util::integrate(speedAt, a, b);
+	}
+	arcLengthTableValid = true;
+}
+
+// Control points of the part of the curve between t = 0 and t, by de Casteljau.
+static void splitStart(float p[4], float t) {
+	const float p12 = p[0] + (p[1] - p[0]) * t;
+	const float p23 = p[1] + (p[2] - p[1]) * t;
+	const float p34 = p[2] + (p[3] - p[2]) * t;
+	const float p123 = p12 + (p23 - p12) * t;
+	const float p234 = p23 + (p34 - p23) * t;
+	p[1] = p12;
+	p[2] = p123;
+	p[3] = p123 + (p234 - p123) * t;
+}
+
+// Control points of the part of the curve between t and t = 1, by de Casteljau.
+static void splitEnd(float p[4], float t) {
+	const float p12 = p[0] + (p[1] - p[0]) * t;
+	const float p23 = p[1] + (p[2] - p[1]) * t;
+	const float p34 = p[2] + (p[3] - p[2]) * t;
+	const float p123 = p12 + (p23 - p12) * t;
+	const float p234 = p23 + (p34 - p23) * t;
+	p[0] = p123 + (p234 - p123) * t;
+	p[1] = p234;
+	p[2] = p34;
+}
+
+void CubicBezierCurve::trim(float t0, float t1) {
+	float xs[4] = { x1, x2, x3, x4 };
+	float ys[4] = { y1, y2, y3, y4 };
+
+	// Cut off the end first, then rescale t0 into the remaining [0, t1] section
+	if (t1 < 1) {
+		splitStart(xs, t1);
+		splitStart(ys, t1);
+	}
+	if (t0 > 0 && t1 > 0) {
+		splitEnd(xs, t0 / t1);
+		splitEnd(ys, t0 / t1);
+	}
+
+	x1 = xs[0]; x2 = xs[1]; x3 = xs[2]; x4 = xs[3];
+	y1 = ys[0]; y2 = ys[1]; y3 = ys[2]; y4 = ys[3];
+
+	len = INVALID_LENGTH;
+	arcLengthTableValid = false;
+}
+
+void CubicBezierCurve::reverse() {
+	std::swap(x1, x4);
+	std::swap(y1, y4);
+	std::swap(x2, x3);
+	std::swap(y2, y3);
+	// The length is unchanged but the cumulative table runs from the other end
+	arcLengthTableValid = false;
+}
+
+float CubicBezierCurve::length(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) {
+	CubicBezierCurve curve(x1, y1, x2, y2, x3, y3, x4, y4);
+	return curve.length();
+}
+
 float CubicBezierCurve::length() {
 	if (len < 0) {
-		// Euclidean distance approximation based on octagonal boundary
-		float dx = std::abs(x4 - x1);
-		float dy = std::abs(y4 - y1);
-
-		len = 0.41 * std::min(dx, dy) + 0.941246 * std::max(dx, dy);
+		if (!arcLengthTableValid) {
+			buildArcLengthTable();
+		}
+		len = arcLengthTable[ARC_LENGTH_SEGMENTS];
 	}
 	return len;
 }
 
+// Appends the roots in (0, 1) of the derivative of one coordinate of the curve.
+static int derivativeRoots(float p1, float p2, float p3, float p4, float* roots) {
+	// B'(t) / 3 = a t^2 + b t + c
+	const float a = -p1 + 3 * p2 - 3 * p3 + p4;
+	const float b = 2 * (p1 - 2 * p2 + p3);
+	const float c = p2 - p1;
+	const float epsilon = 1e-12f;
+
+	int count = 0;
+	auto add = [&](float t) {
+		if (t > 0 && t < 1) {
+			roots[count++] = t;
+		}
+	};
+
+	if (std::abs(a) < epsilon) {
+		if (std::abs(b) > epsilon) {
+			add(-c / b);
+		}
+	} else {
+		const float discriminant = b * b - 4 * a * c;
+		if (discriminant >= 0) {
+			const float root = std::sqrt(discriminant);
+			add((-b + root) / (2 * a));
+			add((-b - root) / (2 * a));
+		}
+	}
+	return count;
+}
+
+BoundingBox CubicBezierCurve::boundingBox(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) {
+	CubicBezierCurve curve(x1, y1, x2, y2, x3, y3, x4, y4);
+	BoundingBox box;
+	box.expand(x1, y1, 0);
+	box.expand(x4, y4, 0);
+
+	float roots[4];
+	int count = derivativeRoots(x1, x2, x3, x4, roots);
+	count += derivativeRoots(y1, y2, y3, y4, roots + count);
+	for (int i = 0; i < count; i++) {
+		Point point = curve.evaluate(roots[i]);
+		box.expand(point.x, point.y, 0);
+	}
+
+	return box;
+}
+
+BoundingBox CubicBezierCurve::boundingBox() {
+	return boundingBox(x1, y1, x2, y2, x3, y3, x4, y4);
+}
+
+void CubicBezierCurve::setArcLengthParameterised(bool enabled) {
+	arcLengthParameterised = enabled;
+}
+
+bool CubicBezierCurve::isArcLengthParameterised() const {
+	return arcLengthParameterised;
+}
+
+float CubicBezierCurve::parameterAtProgress(float drawingProgress) {
+	if (!arcLengthTableValid) {
+		buildArcLengthTable();
+	}
+
+	const float total = arcLengthTable[ARC_LENGTH_SEGMENTS];
+	if (total <= 0) {
+		return drawingProgress;
+	}
+
+	const float target = std::min(std::max(drawingProgress, 0.0f), 1.0f) * total;
+	// First table entry beyond the target, so the target lies in segment (segment - 1, segment]
+	const int segment = (int) (std::upper_bound(arcLengthTable.begin() + 1, arcLengthTable.end() - 1, target) - arcLengthTable.begin());
+	const float segmentStart = arcLengthTable[segment - 1];
+	const float segmentLength = arcLengthTable[segment] - segmentStart;
+	const float fraction = segmentLength > 0 ? (target - segmentStart) / segmentLength : 0;
+
+	return (segment - 1 + fraction) / ARC_LENGTH_SEGMENTS;
+}
+
 std::unique_ptr<Shape> CubicBezierCurve::clone() {
-	return std::make_unique<CubicBezierCurve>(x1, y1, x2, y2, x3, y3, x4, y4);
+	auto curve = std::make_unique<CubicBezierCurve>(x1, y1, x2, y2, x3, y3, x4, y4);
+	curve->setArcLengthParameterised(arcLengthParameterised);
+	return curve;
 }
 
 std::string CubicBezierCurve::type() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include "osci_Shape.h"
 #include "osci_Point.h"
 
@@ -9,13 +10,73 @@ public:
 	CubicBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
 
 	Point nextVector(float drawingProgress) override;
+	void sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z) override;
+	void sampleUniform(float start, float step, int n, float* x, float* y, float* z) override;
 	void scale(float x, float y, float z) override;
 	void translate(float x, float y, float z) override;
+	// Replaces the control points with those of the section between t0 and t1.
+	void trim(float t0, float t1);
+	// Reverses the control points so the curve is drawn from end to start.
+	void reverse();
+	static float length(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
 	float length() override;
+	static BoundingBox boundingBox(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4);
+	BoundingBox boundingBox() override;
 	std::unique_ptr<Shape> clone() override;
 	std::string type() override;
 
+	// When enabled, drawing progress is treated as a fraction of arc length rather
+	// than the curve parameter t, so the beam moves at constant speed along the curve.
+	void setArcLengthParameterised(bool enabled);
+	bool isArcLengthParameterised() const;
+	// Curve parameter t at which the given fraction of the arc length has been drawn.
+	float parameterAtProgress(float drawingProgress);
+
 	float x1, y1, x2, y2, x3, y3, x4, y4;
-	
+
+	static constexpr int ARC_LENGTH_SEGMENTS = 16;
+
+	// Steps through evenly spaced t using forward differencing, which costs three
+	// adds per coordinate per sample. The differences are rebuilt from the exact
+	// polynomial every RESYNC_INTERVAL samples to bound float drift.
+	class Stepper {
+	public:
+		Stepper(const CubicBezierCurve& curve, float start, float step);
+
+		Point next();
+		void generate(int n, float* x, float* y, float* z);
+
+		static constexpr int RESYNC_INTERVAL = 64;
+
+	private:
+		struct Axis {
+			// Power basis coefficients: a t^3 + b t^2 + c t + d
+			float a, b, c, d;
+			// Current value and its first, second and third forward differences
+			float value, delta1, delta2, delta3;
+
+			void set(float p1, float p2, float p3, float p4);
+			void resync(float t, float h);
+			float step();
+		};
+
+		void resync();
+
+		Axis xAxis, yAxis;
+		float start, step;
+		int index = 0;
+		int untilResync = 0;
+	};
+
+private:
+	Point evaluate(float t) const;
+	float speed(float t) const;
+	void buildArcLengthTable();
+
+	bool arcLengthParameterised = false;
+	bool arcLengthTableValid = false;
+	// Cumulative arc length at t = i / ARC_LENGTH_SEGMENTS, built on first use.
+	std::array<float, ARC_LENGTH_SEGMENTS + 1> arcLengthTable{};
+
 };
-} // namespace osci
\ No newline at end of file
+} // namespace osci
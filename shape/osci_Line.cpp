@@ -16,6 +16,29 @@ Point Line::nextVector(float drawingProgress) {
 	);
 }
 
+void Line::sampleBlock(const float* t, int n, float* x, float* y, float* z) {
+	const float dx = x2 - x1;
+	const float dy = y2 - y1;
+	const float dz = z2 - z1;
+	for (int i = 0; i < n; i++) {
+		x[i] = x1 + dx * t[i];
+		y[i] = y1 + dy * t[i];
+		z[i] = z1 + dz * t[i];
+	}
+}
+
+void Line::sampleUniform(float start, float step, int n, float* x, float* y, float* z) {
+	const float dx = x2 - x1;
+	const float dy = y2 - y1;
+	const float dz = z2 - z1;
+	for (int i = 0; i < n; i++) {
+		const float t = start + step * i;
+		x[i] = x1 + dx * t;
+		y[i] = y1 + dy * t;
+		z[i] = z1 + dz * t;
+	}
+}
+
 void Line::scale(float x, float y, float z) {
 	x1 *= x;
 	y1 *= y;
@@ -34,6 +57,24 @@ void Line::translate(float x, float y, float z) {
 	z2 += z;
 }
 
+void Line::trim(float t0, float t1) {
+	Point start = nextVector(t0);
+	Point end = nextVector(t1);
+	x1 = start.x;
+	y1 = start.y;
+	z1 = start.z;
+	x2 = end.x;
+	y2 = end.y;
+	z2 = end.z;
+	len = INVALID_LENGTH;
+}
+
+void Line::reverse() {
+	std::swap(x1, x2);
+	std::swap(y1, y2);
+	std::swap(z1, z2);
+}
+
 float Line::length(float x1, float y1, float z1, float x2, float y2, float z2) {
 	return sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2) + pow(z2 - z1, 2));
 }
@@ -45,6 +86,13 @@ float inline Line::length() {
 	return len;
 }
 
+BoundingBox Line::boundingBox() {
+	BoundingBox box;
+	box.expand(x1, y1, z1);
+	box.expand(x2, y2, z2);
+	return box;
+}
+
 std::unique_ptr<Shape> Line::clone() {
 	return std::make_unique<Line>(x1, y1, z1, x2, y2, z2);
 }
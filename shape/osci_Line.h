@@ -11,10 +11,17 @@ public:
 	Line(Point p1, Point p2);
 
 	Point nextVector(float drawingProgress) override;
+	void sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z) override;
+	void sampleUniform(float start, float step, int n, float* x, float* y, float* z) override;
 	void scale(float x, float y, float z) override;
 	void translate(float x, float y, float z) override;
+	// Restricts the line to the part drawn between progress t0 and t1.
+	void trim(float t0, float t1);
+	// Swaps the endpoints so the line is drawn in the opposite direction.
+	void reverse();
 	static float length(float x1, float y1, float z1, float x2, float y2, float z2);
 	float length() override;
+	BoundingBox boundingBox() override;
 	std::unique_ptr<Shape> clone() override;
 	std::string type() override;
 	Line& operator=(const Line& other);
@@ -15,10 +15,16 @@ Point::Point(float x, float y, float z) : x(x), y(y), z(z), r(-1.0f), g(-1.0f),
 
 Point::Point(float x, float y, float z, float r_, float g_, float b_) : x(x), y(y), z(z), r(r_), g(g_), b(b_) {}
 
+Point::Point(const PointSample& sample) : x(sample.x), y(sample.y), z(sample.z), r(sample.r), g(sample.g), b(sample.b) {}
+
 Point Point::withColour(float r_, float g_, float b_) const {
     return Point(x, y, z, r_, g_, b_);
 }
 
+PointSample Point::toSample() const {
+    return PointSample{ x, y, z, r, g, b };
+}
+
 Point Point::nextVector(float drawingProgress){
     return Point(x, y, z);
 }
@@ -70,6 +76,12 @@ float Point::length() {
     return 0.0;
 }
 
+BoundingBox Point::boundingBox() {
+    BoundingBox box;
+    box.expand(x, y, z);
+    return box;
+}
+
 float Point::magnitude() {
     return sqrt(x * x + y * y + z * z);
 }
@@ -241,6 +253,21 @@ Point Point::fromAudioBuffer(const juce::AudioBuffer<float>& buffer, int sampleI
     return point;
 }
 
+PointSample Point::sampleFromAudioBuffer(const juce::AudioBuffer<float>& buffer, int sampleIndex) {
+    PointSample sample;
+    const int numChannels = buffer.getNumChannels();
+
+    jassert(numChannels <= 6);
+
+    float* const channels[6] = { &sample.x, &sample.y, &sample.z, &sample.r, &sample.g, &sample.b };
+    const int channelsToFill = juce::jmin(numChannels, 6);
+    for (int ch = 0; ch < channelsToFill; ++ch) {
+        *channels[ch] = buffer.getReadPointer(ch)[sampleIndex];
+    }
+
+    return sample;
+}
+
 Point operator+(float scalar, const Point& point) {
     return Point(point.x + scalar, point.y + scalar, point.z + scalar, point.r, point.g, point.b);
 }
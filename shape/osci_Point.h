@@ -1,6 +1,7 @@
 #pragma once
 
 #include "osci_Shape.h"
+#include "osci_PointSample.h"
 #include <cmath>
 #include <string>
 
@@ -13,14 +14,17 @@ public:
     Point(float x, float y);
     Point(float val);
     Point();
+    Point(const PointSample& sample);
 
     // Helper to attach colour to an existing point (non-mutating)
     Point withColour(float r, float g, float b) const;
+    PointSample toSample() const;
 
     Point nextVector(float drawingProgress) override;
     void scale(float x, float y, float z) override;
     void translate(float x, float y, float z) override;
     float length() override;
+    BoundingBox boundingBox() override;
     float magnitude();
     std::unique_ptr<Shape> clone() override;
     std::string type() override;
@@ -62,6 +66,7 @@ public:
 
     // Factory method to create Point from audio buffer sample
     static Point fromAudioBuffer(const juce::AudioBuffer<float>& buffer, int sampleIndex);
+    static PointSample sampleFromAudioBuffer(const juce::AudioBuffer<float>& buffer, int sampleIndex);
 
     float x, y, z; // spatial + legacy brightness/intensity
     float r, g, b; // colour channels: r < 0 means no colour (uses uLineColor); r >= 0 is explicit colour
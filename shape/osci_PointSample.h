@@ -0,0 +1,18 @@
+#pragma once
+
+#include <type_traits>
+
+namespace osci {
+
+// Plain position and colour sample for the audio and concurrency paths. Unlike
+// Point it carries no vtable or cached length, so it is 24 bytes and trivially
+// copyable. Colour follows the Point convention: r < 0 means no explicit colour.
+struct PointSample {
+	float x = 0, y = 0, z = 0;
+	float r = -1, g = -1, b = -1;
+};
+
+static_assert(std::is_trivially_copyable_v<PointSample>);
+static_assert(sizeof(PointSample) == 6 * sizeof(float));
+
+} // namespace osci
@@ -1,9 +1,38 @@
 #include "osci_Shape.h"
 #include "osci_Line.h"
 #include "osci_Point.h"
+#include "osci_Clipper.h"
 
 namespace osci {
 
+void Shape::sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z) {
+	for (int i = 0; i < n; i++) {
+		Point point = nextVector(drawingProgress[i]);
+		x[i] = point.x;
+		y[i] = point.y;
+		z[i] = point.z;
+	}
+}
+
+void Shape::sampleUniform(float start, float step, int n, float* x, float* y, float* z) {
+	for (int i = 0; i < n; i++) {
+		Point point = nextVector(start + step * i);
+		x[i] = point.x;
+		y[i] = point.y;
+		z[i] = point.z;
+	}
+}
+
+BoundingBox Shape::boundingBox() {
+	const int samples = 16;
+	BoundingBox box;
+	for (int i = 0; i <= samples; i++) {
+		Point point = nextVector(i / (float) samples);
+		box.expand(point.x, point.y, point.z);
+	}
+	return box;
+}
+
 float Shape::totalLength(std::vector<std::unique_ptr<Shape>>& shapes) {
     float length = 0.0;
 	for (auto& shape : shapes) {
@@ -12,6 +41,14 @@ float Shape::totalLength(std::vector<std::unique_ptr<Shape>>& shapes) {
 	return length;
 }
 
+BoundingBox Shape::boundingBox(std::vector<std::unique_ptr<Shape>>& shapes) {
+	BoundingBox box;
+	for (auto& shape : shapes) {
+		box.expand(shape->boundingBox());
+	}
+	return box;
+}
+
 void Shape::normalize(std::vector<std::unique_ptr<Shape>>& shapes, float width, float height) {
     float maxDim = std::max(width, height);
     
@@ -24,107 +61,38 @@ void Shape::normalize(std::vector<std::unique_ptr<Shape>>& shapes, float width,
 }
 
 void Shape::normalize(std::vector<std::unique_ptr<Shape>>& shapes) {
-    float oldHeight = height(shapes);
-	float oldWidth = width(shapes);
-	float maxDim = std::max(oldHeight, oldWidth);
-
-	for (auto& shape : shapes) {
-		shape->scale(2.0 / maxDim, -2.0 / maxDim, 2.0 / maxDim);
+	BoundingBox box = boundingBox(shapes);
+	float maxDim = std::max(box.height(), box.width());
+	if (maxDim <= 0) {
+		return;
 	}
 
-	Point max = maxVector(shapes);
-	float newHeight = height(shapes);
+	// Scale to fit [-2, 2] with y flipped, then shift x by -1 and centre y. The
+	// translation is derived from the original box so both apply in one pass.
+	float scale = 2.0 / maxDim;
+	float translateY = scale * (box.minY + box.maxY) / 2.0;
 
 	for (auto& shape : shapes) {
-		shape->translate(-1.0, -max.y + newHeight / 2.0, 0.0);
+		shape->scale(scale, -scale, scale);
+		shape->translate(-1.0, translateY, 0.0);
 	}
 }
 
 float Shape::height(std::vector<std::unique_ptr<Shape>>& shapes) {
-	float maxY = std::numeric_limits<float>::min();
-	float minY = std::numeric_limits<float>::max();
-
-    Point vectors[4];
-
-    for (auto& shape : shapes) {
-        for (int i = 0; i < 4; i++) {
-            vectors[i] = shape->nextVector(i * 1.0 / 4.0);
-        }
-
-        for (auto& vector : vectors) {
-            maxY = std::max(maxY, vector.y);
-            minY = std::min(minY, vector.y);
-        }
-    }
-
-    return std::abs(maxY - minY);
+	return boundingBox(shapes).height();
 }
 
 float Shape::width(std::vector<std::unique_ptr<Shape>>& shapes) {
-    float maxX = std::numeric_limits<float>::min();
-    float minX = std::numeric_limits<float>::max();
-
-    Point vectors[4];
-
-    for (auto& shape : shapes) {
-        for (int i = 0; i < 4; i++) {
-            vectors[i] = shape->nextVector(i * 1.0 / 4.0);
-        }
-
-        for (auto& vector : vectors) {
-            maxX = std::max(maxX, vector.x);
-            minX = std::min(minX, vector.x);
-        }
-    }
-
-    return std::abs(maxX - minX);
+	return boundingBox(shapes).width();
 }
 
 Point Shape::maxVector(std::vector<std::unique_ptr<Shape>>& shapes) {
-    float maxX = std::numeric_limits<float>::min();
-    float maxY = std::numeric_limits<float>::min();
-
-    for (auto& shape : shapes) {
-        Point startVector = shape->nextVector(0);
-        Point endVector = shape->nextVector(1);
-
-        float x = std::max(startVector.x, endVector.x);
-        float y = std::max(startVector.y, endVector.y);
-
-        maxX = std::max(x, maxX);
-        maxY = std::max(y, maxY);
-    }
-
-	return Point(maxX, maxY);
+	BoundingBox box = boundingBox(shapes);
+	return Point(box.maxX, box.maxY);
 }
 
 void Shape::removeOutOfBounds(std::vector<std::unique_ptr<Shape>>& shapes) {
-    std::vector<int> toRemove;
-
-    for (int i = 0; i < shapes.size(); i++) {
-		Point start = shapes[i]->nextVector(0);
-		Point end = shapes[i]->nextVector(1);
-        bool keep = false;
-
-        if ((start.x < 1 && start.x > -1) || (start.y < 1 && start.y > -1)) {
-            if ((end.x < 1 && end.x > -1) || (end.y < 1 && end.y > -1)) {
-				if (shapes[i]->type() == "Line") {
-                    Point newStart(std::min(std::max(start.x, -1.0f), 1.0f), std::min(std::max(start.y, -1.0f), 1.0f));
-                    Point newEnd(std::min(std::max(end.x, -1.0f), 1.0f), std::min(std::max(end.y, -1.0f), 1.0f));
-					shapes[i] = std::make_unique<Line>(newStart.x, newStart.y, newEnd.x, newEnd.y);
-                }
-                keep = true;
-            }
-        }
-
-        if (!keep) {
-            toRemove.push_back(i);
-        }
-    }
-
-    for (int i = static_cast<int>(toRemove.size()) - 1; i >= 0; i--) {
-        shapes.erase(shapes.begin() + toRemove[i]);
-    }
+	Clipper::clip(shapes);
 }
 
 } // namespace osci
\ No newline at end of file
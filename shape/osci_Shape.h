@@ -1,25 +1,70 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 #include <memory>
 #include <string>
 
 namespace osci {
 class Point;
+
+// Axis-aligned extents of one or more shapes. Starts empty, with min above max.
+struct BoundingBox {
+	float minX = std::numeric_limits<float>::max();
+	float minY = std::numeric_limits<float>::max();
+	float minZ = std::numeric_limits<float>::max();
+	float maxX = std::numeric_limits<float>::lowest();
+	float maxY = std::numeric_limits<float>::lowest();
+	float maxZ = std::numeric_limits<float>::lowest();
+
+	bool isEmpty() const { return minX > maxX; }
+	float width() const { return isEmpty() ? 0 : maxX - minX; }
+	float height() const { return isEmpty() ? 0 : maxY - minY; }
+
+	void expand(float x, float y, float z) {
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		minZ = std::min(minZ, z);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		maxZ = std::max(maxZ, z);
+	}
+
+	void expand(const BoundingBox& other) {
+		minX = std::min(minX, other.minX);
+		minY = std::min(minY, other.minY);
+		minZ = std::min(minZ, other.minZ);
+		maxX = std::max(maxX, other.maxX);
+		maxY = std::max(maxY, other.maxY);
+		maxZ = std::max(maxZ, other.maxZ);
+	}
+};
+
 class Shape {
 public:
 	virtual ~Shape() = default;
 
 	virtual Point nextVector(float drawingProgress) = 0;
+	// Evaluates n samples at once so callers dispatch once per shape per block
+	// rather than once per sample. z is written even for 2D shapes.
+	virtual void sampleBlock(const float* drawingProgress, int n, float* x, float* y, float* z);
+	// Evaluates n samples at evenly spaced drawing progress start, start + step, ...
+	// which lets shapes use incremental evaluators instead of evaluating from scratch.
+	virtual void sampleUniform(float start, float step, int n, float* x, float* y, float* z);
 	virtual void scale(float x, float y, float z) = 0;
 	virtual void translate(float x, float y, float z) = 0;
 	virtual float length() = 0;
+	// Exact extents of the shape. The default samples the shape, so subclasses
+	// should override it when their extents can be computed directly.
+	virtual BoundingBox boundingBox();
 	virtual std::unique_ptr<Shape> clone() = 0;
 	virtual std::string type() = 0;
 
 	static float totalLength(std::vector<std::unique_ptr<Shape>>&);
+	static BoundingBox boundingBox(std::vector<std::unique_ptr<Shape>>&);
 	static void normalize(std::vector<std::unique_ptr<Shape>>&, float, float);
 	static void normalize(std::vector<std::unique_ptr<Shape>>&);
 	static float height(std::vector<std::unique_ptr<Shape>>&);
@@ -27,7 +72,7 @@ public:
 	static Point maxVector(std::vector<std::unique_ptr<Shape>>&);
 	static void removeOutOfBounds(std::vector<std::unique_ptr<Shape>>&);
 
-	const float INVALID_LENGTH = -1.0;
+	static constexpr float INVALID_LENGTH = -1.0;
 
 	float len = INVALID_LENGTH;
 };
@@ -0,0 +1,113 @@
+#include "osci_Transform3D.h"
+
+namespace osci {
+
+// Keeps points at or behind the camera from dividing by zero or flipping over.
+static constexpr float MIN_PERSPECTIVE_DEPTH = 1e-3f;
+
+Transform3D::Transform3D() : m{ { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } } {}
+
+Transform3D Transform3D::rotation(float rotateX, float rotateY, float rotateZ) {
+	const float cx = std::cos(rotateX), sx = std::sin(rotateX);
+	const float cy = std::cos(rotateY), sy = std::sin(rotateY);
+	const float cz = std::cos(rotateZ), sz = std::sin(rotateZ);
+
+	// Rz * Ry * Rx
+	Transform3D transform;
+	transform.m[0][0] = cz * cy;
+	transform.m[0][1] = cz * sy * sx - sz * cx;
+	transform.m[0][2] = cz * sy * cx + sz * sx;
+	transform.m[1][0] = sz * cy;
+	transform.m[1][1] = sz * sy * sx + cz * cx;
+	transform.m[1][2] = sz * sy * cx - cz * sx;
+	transform.m[2][0] = -sy;
+	transform.m[2][1] = cy * sx;
+	transform.m[2][2] = cy * cx;
+	return transform;
+}
+
+Transform3D Transform3D::scale(float x, float y, float z) {
+	Transform3D transform;
+	transform.m[0][0] = x;
+	transform.m[1][1] = y;
+	transform.m[2][2] = z;
+	return transform;
+}
+
+Transform3D Transform3D::translation(float x, float y, float z) {
+	Transform3D transform;
+	transform.m[0][3] = x;
+	transform.m[1][3] = y;
+	transform.m[2][3] = z;
+	return transform;
+}
+
+Transform3D Transform3D::operator*(const Transform3D& other) const {
+	Transform3D result;
+	for (int row = 0; row < 3; row++) {
+		for (int column = 0; column < 4; column++) {
+			float sum = column == 3 ? m[row][3] : 0.0f;
+			for (int k = 0; k < 3; k++) {
+				sum += m[row][k] * other.m[k][column];
+			}
+			result.m[row][column] = sum;
+		}
+	}
+	return result;
+}
+
+Point Transform3D::apply(const Point& point) const {
+	Point result = point;
+	result.x = m[0][0] * point.x + m[0][1] * point.y + m[0][2] * point.z + m[0][3];
+	result.y = m[1][0] * point.x + m[1][1] * point.y + m[1][2] * point.z + m[1][3];
+	result.z = m[2][0] * point.x + m[2][1] * point.y + m[2][2] * point.z + m[2][3];
+	return result;
+}
+
+void Transform3D::apply(float* x, float* y, float* z, int n) const {
+	// Copied to locals so the compiler knows stores to the arrays can't change them
+	const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2], m03 = m[0][3];
+	const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2], m13 = m[1][3];
+	const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2], m23 = m[2][3];
+
+	for (int i = 0; i < n; i++) {
+		const float px = x[i], py = y[i], pz = z[i];
+		x[i] = m00 * px + m01 * py + m02 * pz + m03;
+		y[i] = m10 * px + m11 * py + m12 * pz + m13;
+		z[i] = m20 * px + m21 * py + m22 * pz + m23;
+	}
+}
+
+void Transform3D::applyWithPerspective(float* x, float* y, float* z, int n, float focalLength, float cameraDistance) const {
+	const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2], m03 = m[0][3];
+	const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2], m13 = m[1][3];
+	const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2], m23 = m[2][3];
+
+	for (int i = 0; i < n; i++) {
+		const float px = x[i], py = y[i], pz = z[i];
+		const float tz = m20 * px + m21 * py + m22 * pz + m23;
+		const float depth = std::max(tz + cameraDistance, MIN_PERSPECTIVE_DEPTH);
+		const float projection = focalLength / depth;
+		x[i] = (m00 * px + m01 * py + m02 * pz + m03) * projection;
+		y[i] = (m10 * px + m11 * py + m12 * pz + m13) * projection;
+		z[i] = tz;
+	}
+}
+
+void Transform3D::applyToPlane(float* x, float* y, int n) const {
+	const float m00 = m[0][0], m01 = m[0][1], m03 = m[0][3];
+	const float m10 = m[1][0], m11 = m[1][1], m13 = m[1][3];
+
+	for (int i = 0; i < n; i++) {
+		const float px = x[i], py = y[i];
+		x[i] = m00 * px + m01 * py + m03;
+		y[i] = m10 * px + m11 * py + m13;
+	}
+}
+
+bool Transform3D::isIdentity() const {
+	const Transform3D identity;
+	return std::equal(&m[0][0], &m[0][0] + 12, &identity.m[0][0]);
+}
+
+} // namespace osci
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "osci_Point.h"
+
+namespace osci {
+
+// Affine 3D transform stored as a 3x4 matrix, so the trig for a rotation is done
+// once per block or frame rather than once per point as in Point::rotate.
+class Transform3D {
+public:
+	// Identity
+	Transform3D();
+
+	// Same rotation as Point::rotate: around x, then y, then z.
+	static Transform3D rotation(float rotateX, float rotateY, float rotateZ);
+	static Transform3D scale(float x, float y, float z);
+	static Transform3D translation(float x, float y, float z);
+
+	// Transform that applies other first and then this.
+	Transform3D operator*(const Transform3D& other) const;
+
+	Point apply(const Point& point) const;
+	// Transforms n points held as separate coordinate arrays, in place. The loop
+	// has no branches or calls so the compiler can vectorise it.
+	void apply(float* x, float* y, float* z, int n) const;
+	// As above, then projects each point onto the z = 0 plane as seen by a camera
+	// cameraDistance behind it with the given focal length. z keeps the depth.
+	void applyWithPerspective(float* x, float* y, float* z, int n, float focalLength, float cameraDistance) const;
+
+	// Transforms points on the z = 0 plane and drops the resulting z, for 2D shapes.
+	void applyToPlane(float* x, float* y, int n) const;
+
+	bool isIdentity() const;
+
+	// Row-major, with the translation in the last column
+	float m[3][4];
+};
+
+} // namespace osci